@@ -0,0 +1,38 @@
+#ifndef BVH_H
+#define BVH_H
+
+#include "math3d.h"
+
+#define BVH_LEAF_EDGES 8
+
+// Axis-aligned box node covering edge_index[first .. first+count)
+typedef struct {
+    float min[3], max[3];
+    int left, right;     // child node indices, -1 for leaves
+    int first, count;
+} bvh_node_t;
+
+// Bounding volume hierarchy over the edges of a static mesh (model space)
+typedef struct {
+    bvh_node_t* nodes;
+    int node_count;
+    int* edge_index;     // edges reordered so every leaf is a contiguous range
+    int edge_count;
+} bvh_t;
+
+// Called for each visible leaf with its slice of bvh->edge_index
+typedef void (*bvh_visit_fn)(const int* edge_ids, int count, void* user);
+
+bvh_t* bvh_build(const vec3_t* vertices, const int edges[][2], int ecount);
+void bvh_destroy(bvh_t* bvh);
+
+// Walks the tree against the clip-space frustum of mvp (proj * view * model).
+// Subtrees whose screen footprint is below min_pixels are skipped.
+void bvh_traverse(const bvh_t* bvh, const mat4_t* mvp, int width, int height,
+                  float min_pixels, bvh_visit_fn visit, void* user);
+
+// Binary persistence so the tree can be stored next to the mesh data
+int bvh_save(const bvh_t* bvh, const char* filename);
+bvh_t* bvh_load(const char* filename);
+
+#endif
@@ -1,11 +1,20 @@
 #ifndef CANVAS_H
 #define CANVAS_H
 
+#include <stdio.h>
+#include "jobs.h"
+
 typedef struct {
     int width, height;
     float *data;
 } canvas_t;
 
+// 8-bit canvas written by the fixed-point pipeline (see fixed.h)
+typedef struct {
+    int width, height;
+    unsigned char *data;
+} canvas8_t;
+
 canvas_t* canvas_create(int width, int height);
 void canvas_clear(canvas_t* c, float value);
 void canvas_save(canvas_t* c, int frame);
@@ -15,4 +24,38 @@ void set_pixel_f(canvas_t* c, float x, float y, float intensity);
 void draw_line_f(canvas_t* c, float x0, float y0, float x1, float y1, float thickness);
 void canvas_to_pgm(canvas_t* c, const char* filename);
 
+// draw_line_f restricted to pixels in [xmin, xmax) x [ymin, ymax); the union
+// over a tiling of the canvas is identical to one draw_line_f call
+void draw_line_f_clipped(canvas_t* c, float x0, float y0, float x1, float y1, float intensity,
+                         int xmin, int ymin, int xmax, int ymax);
+
+// draw_line_f into a horizontal strip: band holds image rows
+// [y_origin, y_origin + band->height) and receives exactly the pixels a
+// full-size canvas would get in those rows
+void draw_line_f_band(canvas_t* band, float x0, float y0, float x1, float y1, float intensity,
+                      int y_origin);
+
+// Same output as canvas_to_pgm, with rows formatted on the job system
+void canvas_to_pgm_mt(job_system_t* js, canvas_t* c, const char* filename);
+
+// Streaming binary (P5) PGM writer: rows are appended top to bottom from
+// canvases of the image width, so the full image never has to be in memory
+typedef struct {
+    FILE* f;
+    int width, height;
+    int rows_written;
+    unsigned char* row;
+} pgm_writer_t;
+
+pgm_writer_t* pgm_writer_open(const char* filename, int width, int height);
+// Appends the first rows rows of band; returns 0, or -1 on I/O error or overrun
+int pgm_writer_rows(pgm_writer_t* w, const canvas_t* band, int rows);
+// Returns -1 if fewer than height rows were written or the file failed to flush
+int pgm_writer_close(pgm_writer_t* w);
+
+canvas8_t* canvas8_create(int width, int height);
+void canvas8_clear(canvas8_t* c, unsigned char value);
+void canvas8_destroy(canvas8_t* c);
+void canvas8_to_pgm(canvas8_t* c, const char* filename);
+
 #endif
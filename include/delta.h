@@ -0,0 +1,42 @@
+#ifndef DELTA_H
+#define DELTA_H
+
+#include <stdio.h>
+#include "canvas.h"
+
+#define DELTA_TILE 16
+
+// Frame sequence writer: a keyframe followed by per-frame deltas of the
+// changed DELTA_TILE x DELTA_TILE tiles, with zero runs RLE-compressed.
+// Pixels are stored at the same 8-bit precision as canvas_to_pgm.
+typedef struct {
+    FILE* file;
+    int width, height;
+    int keyframe_interval;   // 0 = only the first frame is a keyframe
+    int frame_count;
+    unsigned char* prev;     // last written frame
+    unsigned char* cur;
+    unsigned char* payload;  // scratch for one encoded frame
+} delta_writer_t;
+
+typedef struct {
+    FILE* file;
+    int width, height;
+    int frame_count;
+    long* offsets;           // file offset of each frame record
+    unsigned char* types;    // 'K' or 'D' per frame
+    unsigned char* pixels;   // last decoded frame
+    unsigned char* payload;
+    int decoded;             // index held in pixels, -1 if none
+} delta_reader_t;
+
+delta_writer_t* delta_writer_open(const char* filename, int width, int height, int keyframe_interval);
+int delta_writer_add(delta_writer_t* w, const canvas_t* c);
+int delta_writer_add8(delta_writer_t* w, const canvas8_t* c);
+void delta_writer_close(delta_writer_t* w);
+
+delta_reader_t* delta_reader_open(const char* filename);
+int delta_reader_frame(delta_reader_t* r, int index, canvas_t* out);
+void delta_reader_close(delta_reader_t* r);
+
+#endif
@@ -0,0 +1,58 @@
+#ifndef FIXED_H
+#define FIXED_H
+
+#include <stdint.h>
+#include "canvas.h"
+#include "math3d.h"
+
+// Q16.16 fixed-point pipeline for targets without a fast FPU.
+// Build with `make FIXED=1` to make the demo render through it.
+
+typedef int32_t fx_t;
+
+#define FX_SHIFT 16
+#define FX_ONE   (1 << FX_SHIFT)
+
+// Largest screen coordinate magnitude (exclusive, Q16.16: 16384 px) that
+// draw_line_fx accepts, so x1 - x0 can't overflow. Lines are clipped back to
+// it by render_wireframe_lit_fx; canvases must be smaller than this.
+#define FX_COORD_LIMIT ((int64_t)1 << 30)
+// NDC depth is clamped to +-64 before the attenuation squares it
+#define FX_Z_LIMIT     (64 * FX_ONE)
+
+typedef struct { fx_t x, y, z; } vec3_fx_t;
+typedef struct { fx_t m[16]; } mat4_fx_t;   // column-major, like mat4_t
+
+static inline fx_t fx_from_float(float f) {
+    return (fx_t)(f * (float)FX_ONE + (f >= 0.0f ? 0.5f : -0.5f));
+}
+
+static inline float fx_to_float(fx_t a) {
+    return (float)a / (float)FX_ONE;
+}
+
+static inline fx_t fx_mul(fx_t a, fx_t b) {
+    return (fx_t)(((int64_t)a * b) >> FX_SHIFT);
+}
+
+// 1/x from a 256-entry table with linear interpolation (no divide)
+fx_t fx_recip(fx_t x);
+fx_t fx_sqrt(fx_t x);
+
+// Conversions done once per mesh / per frame, outside the pixel loops
+vec3_fx_t vec3_to_fx(vec3_t v);
+void mat4_to_fx(mat4_fx_t* out, const mat4_t* m);
+void mat4_fx_multiply(mat4_fx_t* out, const mat4_fx_t* a, const mat4_fx_t* b);
+
+// Lines with any coordinate outside +-FX_COORD_LIMIT are not drawn
+void draw_line_fx(canvas8_t* c, fx_t x0, fx_t y0, fx_t x1, fx_t y1, unsigned char intensity);
+
+// Integer-only counterpart of render_wireframe_lit
+void render_wireframe_lit_fx(canvas8_t* canvas,
+                             const vec3_fx_t* vertices, const int edges[][2],
+                             int vcount, int ecount,
+                             const mat4_fx_t* model, const mat4_fx_t* view, const mat4_fx_t* proj,
+                             const vec3_fx_t* lights, int light_count,
+                             fx_t ambient);
+
+#endif
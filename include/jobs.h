@@ -0,0 +1,26 @@
+#ifndef JOBS_H
+#define JOBS_H
+
+// Fixed worker pool with per-worker Chase-Lev deques and work stealing.
+// A pool created with N threads has N - 1 workers plus one seat for
+// threads outside the pool: the submitter holding the seat helps execute
+// jobs, while other outside submitters sleep until their loop is done. At
+// most N threads therefore run jobs at once, however many threads submit.
+// Every API taking a job_system_t* also accepts NULL (or a 1-thread pool)
+// and then runs serially on the caller.
+
+typedef struct job_system job_system_t;
+
+// Processes items [begin, end) of a parallel loop
+typedef void (*job_range_fn)(void* ctx, int begin, int end);
+
+// threads = total parallelism including the caller (<= 0: one per core)
+job_system_t* jobs_create(int threads);
+void jobs_destroy(job_system_t* js);
+int jobs_thread_count(const job_system_t* js);
+
+// Splits [0, count) into chunks of `grain` items (<= 0: automatic) and
+// returns once all of them have run. May be nested from inside a job.
+void jobs_parallel_for(job_system_t* js, int count, int grain, job_range_fn fn, void* ctx);
+
+#endif
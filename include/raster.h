@@ -0,0 +1,31 @@
+#ifndef RASTER_H
+#define RASTER_H
+
+#include "canvas.h"
+
+// Half-space triangle rasterizer. The bounding box is walked in
+// RASTER_BLOCK x RASTER_BLOCK blocks: blocks outside an edge are rejected,
+// blocks inside all three edges are filled without edge tests, and only
+// blocks crossing an edge are tested per pixel (4 pixels per SSE2 op when
+// available). Pixel centres are sampled with a top-left fill rule, so
+// triangles sharing an edge never overlap or leave gaps.
+#define RASTER_BLOCK 8
+
+// Fills a screen-space triangle with a flat intensity. If depth is non-NULL
+// (a canvas of the same size, cleared to 1.0f) pixels are only written where
+// the interpolated z is nearer than the stored value.
+void fill_triangle_f(canvas_t* c, canvas_t* depth,
+                     float x0, float y0, float z0,
+                     float x1, float y1, float z1,
+                     float x2, float y2, float z2,
+                     float intensity);
+
+// Samples like draw_line_f with z interpolated along the line, but only
+// where z <= depth + bias, and overwrites instead of max-blending: an edge
+// overlay on top of fill_triangle_f output. depth is not updated.
+void draw_line_depth_f(canvas_t* c, const canvas_t* depth,
+                       float x0, float y0, float z0,
+                       float x1, float y1, float z1,
+                       float intensity, float bias);
+
+#endif
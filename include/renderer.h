@@ -3,6 +3,8 @@
 
 #include "canvas.h"
 #include "math3d.h"
+#include "bvh.h"
+#include "jobs.h"
 
 // Basic unlit wireframe renderer
 void render_wireframe(canvas_t* canvas, vec3_t* vertices, int edges[][2],
@@ -18,6 +20,80 @@ void render_wireframe_lit(canvas_t* canvas,
                           const vec3_t* lights, int light_count,
                           float ambient);
 
+// render_wireframe_lit on the job system: vertex transform, edge setup and
+// binning run as parallel loops, then each 64x64 tile is rasterized by one
+// job. Output is identical to render_wireframe_lit; like it, vcount is not
+// trusted and only vertices referenced by edges are read.
+void render_wireframe_lit_mt(job_system_t* js, canvas_t* canvas,
+                             const vec3_t* vertices, const int edges[][2],
+                             int vcount, int ecount,
+                             const mat4_t* model, const mat4_t* view, const mat4_t* proj,
+                             const vec3_t* lights, int light_count,
+                             float ambient);
+
+// Lit wireframe restricted to BVH leaves inside the view frustum; subtrees
+// smaller than min_pixels on screen are skipped (pass 0 to draw everything visible).
+// Nothing is drawn unless bvh was built over exactly ecount edges.
+void render_wireframe_lit_bvh(canvas_t* canvas, const bvh_t* bvh,
+                              const vec3_t* vertices, const int edges[][2], int ecount,
+                              const mat4_t* model, const mat4_t* view, const mat4_t* proj,
+                              const vec3_t* lights, int light_count,
+                              float ambient, float min_pixels);
+
+// Flat-shaded filled polygons: faces is face_count rows of face_stride vertex
+// indices (rows shorter than face_stride end with -1), fan-triangulated.
+// Faces with more than RENDER_FACE_MAX vertices are skipped. Each face gets
+// one Lambert intensity from its normal; depth may be NULL, otherwise a
+// same-size canvas cleared to 1.0f. Use render_wireframe_overlay afterwards
+// for an edge overlay.
+#define RENDER_FACE_MAX 16
+void render_faces_lit(canvas_t* canvas, canvas_t* depth,
+                      const vec3_t* vertices, const int* faces, int face_stride, int face_count,
+                      const mat4_t* model, const mat4_t* view, const mat4_t* proj,
+                      const vec3_t* lights, int light_count,
+                      float ambient);
+
+// Lit wireframe drawn over render_faces_lit output: each edge is depth tested
+// against the faces' depth canvas (passing within bias) and overwrites the
+// face pixels, so hidden edges stay hidden and visible ones show on bright
+// faces. Edges crossing the near/far planes are skipped, as faces are.
+void render_wireframe_overlay(canvas_t* canvas, const canvas_t* depth,
+                              const vec3_t* vertices, const int edges[][2], int ecount,
+                              const mat4_t* model, const mat4_t* view, const mat4_t* proj,
+                              const vec3_t* lights, int light_count,
+                              float ambient, float bias);
+
+// Out-of-core lit wireframe for images too large to hold in memory. Edges
+// are projected and shaded as they are added; band_renderer_write_pgm then
+// sorts them by their first band_height-row strip and sweeps the strips top
+// to bottom with an active-edge list, rasterizing each strip into one
+// reusable band canvas and streaming it to a binary PGM. Memory is
+// width * band_height floats plus O(edges), whatever the image height; the
+// pixels match render_wireframe_lit on a full canvas.
+typedef struct {
+    float x0, y0, x1, y1, intensity;
+} band_edge_t;
+
+typedef struct {
+    int width, height, band_height;
+    canvas_t* band;              // strip buffer reused for every band
+    band_edge_t* edges;          // screen-space edges, off-image ones culled
+    int edge_count, edge_capacity;
+} band_renderer_t;
+
+band_renderer_t* band_renderer_create(int width, int height, int band_height);
+// Both add functions return 0, or -1 if the edge list could not grow
+int band_renderer_add_lit(band_renderer_t* br,
+                          const vec3_t* vertices, const int edges[][2], int ecount,
+                          const mat4_t* model, const mat4_t* view, const mat4_t* proj,
+                          const vec3_t* lights, int light_count, float ambient);
+int band_renderer_add_line(band_renderer_t* br, float x0, float y0, float x1, float y1,
+                           float intensity);
+// Returns 0, or -1 on allocation or I/O failure. The edge list is kept, so
+// the same scene can be written again.
+int band_renderer_write_pgm(band_renderer_t* br, const char* filename);
+void band_renderer_destroy(band_renderer_t* br);
+
 // Computes per-edge brightness from lighting
 float edge_brightness(vec3_t v0, vec3_t v1, const mat4_t* model,
                       const mat4_t* view, const mat4_t* proj,
@@ -0,0 +1,45 @@
+#ifndef SHMRING_H
+#define SHMRING_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "canvas.h"
+
+// Ring of N float framebuffers in POSIX shared memory. The publisher renders
+// straight into a slot; viewers map the same object and read the newest
+// slot in place. Each slot carries a seqlock counter (odd while being
+// written) so readers can detect frames overwritten under them.
+
+typedef struct {
+    char name[64];
+    int fd;
+    int owner;               // created (and unlinked on destroy) by this process
+    unsigned char* base;
+    size_t size, slot_stride;
+    int slot_count, width, height;
+    uint64_t frame;          // last frame number published / begun by the owner
+    canvas_t canvas;         // view of the slot being written; never canvas_destroy it
+} shm_ring_t;
+
+// Publisher side. Fails if name is in use by a live publisher; an object
+// left by a crashed one is detected (its publisher lock is gone) and
+// replaced. SHM_RING_REPLACE removes any existing object unconditionally.
+#define SHM_RING_REPLACE 1
+shm_ring_t* shm_ring_create(const char* name, int slot_count, int width, int height, int flags);
+canvas_t* shm_ring_begin_frame(shm_ring_t* r);
+void shm_ring_publish(shm_ring_t* r);
+
+// Consumer side. Zero-copy: shm_ring_read_begin returns the newest frame in
+// place (NULL if none yet); the pixels are only valid if shm_ring_read_end
+// then returns 1.
+shm_ring_t* shm_ring_open(const char* name);
+const float* shm_ring_read_begin(shm_ring_t* r, uint64_t* frame, uint32_t* token);
+int shm_ring_read_end(shm_ring_t* r, uint64_t frame, uint32_t token);
+uint64_t shm_ring_latest(const shm_ring_t* r);
+
+// Copies the newest complete frame into out; returns its number or 0
+uint64_t shm_ring_read_latest(shm_ring_t* r, canvas_t* out);
+
+void shm_ring_destroy(shm_ring_t* r);
+
+#endif
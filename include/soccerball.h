@@ -5,9 +5,13 @@
 
 #define SOCCERBALL_VERTEX_COUNT 60
 #define SOCCERBALL_EDGE_MAX 180
+#define SOCCERBALL_FACE_COUNT 32
+#define SOCCERBALL_FACE_MAX 6     // vertices per face row, -1 padded (pentagons)
 
 void generate_soccerball(vec3_t vertices[SOCCERBALL_VERTEX_COUNT],
                          int edges[SOCCERBALL_EDGE_MAX][2],
                          int* edge_count);
 
+void generate_soccerball_faces(int faces[SOCCERBALL_FACE_COUNT][SOCCERBALL_FACE_MAX]);
+
 #endif
@@ -0,0 +1,283 @@
+#include "bvh.h"
+#include <stdlib.h>
+#include <stdio.h>
+#include <float.h>
+#include <limits.h>
+
+#define BVH_MAGIC 0x56423354u   // "T3BV"
+#define BVH_VERSION 1u
+#define BVH_STACK_MAX 64
+
+typedef struct {
+    const vec3_t* vertices;
+    const int (*edges)[2];
+    float* centroids;    // 3 floats per edge
+    bvh_t* bvh;
+} bvh_builder_t;
+
+static void edge_bounds(const bvh_builder_t* b, int e, float mn[3], float mx[3]) {
+    vec3_t p = b->vertices[b->edges[e][0]];
+    vec3_t q = b->vertices[b->edges[e][1]];
+    mn[0] = p.x < q.x ? p.x : q.x;  mx[0] = p.x > q.x ? p.x : q.x;
+    mn[1] = p.y < q.y ? p.y : q.y;  mx[1] = p.y > q.y ? p.y : q.y;
+    mn[2] = p.z < q.z ? p.z : q.z;  mx[2] = p.z > q.z ? p.z : q.z;
+}
+
+// Partially orders ids[lo..hi] so ids[k] holds the k-th smallest centroid on axis
+static void select_nth(const float* centroids, int* ids, int lo, int hi, int k, int axis) {
+    while (lo < hi) {
+        float pivot = centroids[ids[(lo + hi) / 2] * 3 + axis];
+        int i = lo, j = hi;
+        while (i <= j) {
+            while (centroids[ids[i] * 3 + axis] < pivot) ++i;
+            while (centroids[ids[j] * 3 + axis] > pivot) --j;
+            if (i <= j) {
+                int t = ids[i]; ids[i] = ids[j]; ids[j] = t;
+                ++i; --j;
+            }
+        }
+        if (k <= j) hi = j;
+        else if (k >= i) lo = i;
+        else return;
+    }
+}
+
+static int build_node(bvh_builder_t* b, int first, int count) {
+    bvh_t* bvh = b->bvh;
+    int index = bvh->node_count++;
+    bvh_node_t* n = &bvh->nodes[index];
+
+    float cmin[3] = { FLT_MAX, FLT_MAX, FLT_MAX };
+    float cmax[3] = { -FLT_MAX, -FLT_MAX, -FLT_MAX };
+    for (int a = 0; a < 3; ++a) { n->min[a] = FLT_MAX; n->max[a] = -FLT_MAX; }
+
+    for (int i = first; i < first + count; ++i) {
+        int e = bvh->edge_index[i];
+        float mn[3], mx[3];
+        edge_bounds(b, e, mn, mx);
+        for (int a = 0; a < 3; ++a) {
+            if (mn[a] < n->min[a]) n->min[a] = mn[a];
+            if (mx[a] > n->max[a]) n->max[a] = mx[a];
+            float c = b->centroids[e * 3 + a];
+            if (c < cmin[a]) cmin[a] = c;
+            if (c > cmax[a]) cmax[a] = c;
+        }
+    }
+
+    n->first = first;
+    n->count = count;
+    n->left = n->right = -1;
+    if (count <= BVH_LEAF_EDGES) return index;
+
+    // Object median along the widest centroid axis keeps the tree balanced
+    int axis = 0;
+    for (int a = 1; a < 3; ++a)
+        if (cmax[a] - cmin[a] > cmax[axis] - cmin[axis]) axis = a;
+    int half = count / 2;
+    select_nth(b->centroids, bvh->edge_index, first, first + count - 1, first + half, axis);
+
+    int left = build_node(b, first, half);
+    int right = build_node(b, first + half, count - half);
+    n = &bvh->nodes[index];
+    n->left = left;
+    n->right = right;
+    return index;
+}
+
+bvh_t* bvh_build(const vec3_t* vertices, const int edges[][2], int ecount) {
+    bvh_t* bvh = calloc(1, sizeof(bvh_t));
+    if (!bvh) return NULL;
+    int cap = ecount > 0 ? 2 * ecount : 1;
+    bvh->nodes = malloc((size_t)cap * sizeof(bvh_node_t));
+    bvh->edge_index = malloc((size_t)(ecount > 0 ? ecount : 1) * sizeof(int));
+    float* centroids = malloc((size_t)(ecount > 0 ? ecount : 1) * 3 * sizeof(float));
+    if (!bvh->nodes || !bvh->edge_index || !centroids) {
+        free(centroids);
+        bvh_destroy(bvh);
+        return NULL;
+    }
+
+    for (int e = 0; e < ecount; ++e) {
+        vec3_t p = vertices[edges[e][0]], q = vertices[edges[e][1]];
+        centroids[e * 3 + 0] = (p.x + q.x) * 0.5f;
+        centroids[e * 3 + 1] = (p.y + q.y) * 0.5f;
+        centroids[e * 3 + 2] = (p.z + q.z) * 0.5f;
+        bvh->edge_index[e] = e;
+    }
+    bvh->edge_count = ecount;
+
+    if (ecount > 0) {
+        bvh_builder_t b = { vertices, edges, centroids, bvh };
+        build_node(&b, 0, ecount);
+    }
+    free(centroids);
+    return bvh;
+}
+
+void bvh_destroy(bvh_t* bvh) {
+    if (bvh) {
+        free(bvh->nodes);
+        free(bvh->edge_index);
+        free(bvh);
+    }
+}
+
+// Returns -1 if the box is outside the frustum, 1 if fully inside, 0 if straddling.
+// *pixels receives the larger screen extent, or FLT_MAX when the box crosses w = 0.
+static int classify_box(const bvh_node_t* n, const mat4_t* m, int width, int height,
+                        float* pixels) {
+    int out_mask_all = 0x3f, out_mask_any = 0;
+    int behind = 0;
+    // x/y planes pushed out by a pixel: draw_line_f truncates, so a line up
+    // to one pixel left of or above the canvas still lands in column/row 0
+    float kx = 1.0f + 2.0f / width, ky = 1.0f + 2.0f / height;
+    float sx0 = FLT_MAX, sy0 = FLT_MAX, sx1 = -FLT_MAX, sy1 = -FLT_MAX;
+
+    for (int c = 0; c < 8; ++c) {
+        float x = (c & 1) ? n->max[0] : n->min[0];
+        float y = (c & 2) ? n->max[1] : n->min[1];
+        float z = (c & 4) ? n->max[2] : n->min[2];
+        float cx = m->m[0]*x + m->m[4]*y + m->m[8]*z  + m->m[12];
+        float cy = m->m[1]*x + m->m[5]*y + m->m[9]*z  + m->m[13];
+        float cz = m->m[2]*x + m->m[6]*y + m->m[10]*z + m->m[14];
+        float cw = m->m[3]*x + m->m[7]*y + m->m[11]*z + m->m[15];
+
+        int mask = 0;
+        if (cx < -cw * kx) mask |= 1;
+        if (cx >  cw * kx) mask |= 2;
+        if (cy < -cw * ky) mask |= 4;
+        if (cy >  cw * ky) mask |= 8;
+        if (cz < -cw) mask |= 16;
+        if (cz >  cw) mask |= 32;
+        out_mask_all &= mask;
+        out_mask_any |= mask;
+
+        if (cw <= 0.0f) {
+            behind = 1;
+        } else {
+            float px = cx / cw, py = cy / cw;
+            if (px < sx0) sx0 = px;
+            if (px > sx1) sx1 = px;
+            if (py < sy0) sy0 = py;
+            if (py > sy1) sy1 = py;
+        }
+    }
+
+    if (out_mask_all) return -1;
+    if (behind) {
+        *pixels = FLT_MAX;
+    } else {
+        float w = (sx1 - sx0) * 0.5f * width;
+        float h = (sy1 - sy0) * 0.5f * height;
+        *pixels = w > h ? w : h;
+    }
+    return out_mask_any ? 0 : 1;
+}
+
+void bvh_traverse(const bvh_t* bvh, const mat4_t* mvp, int width, int height,
+                  float min_pixels, bvh_visit_fn visit, void* user) {
+    if (!bvh || bvh->node_count == 0) return;
+
+    int stack[BVH_STACK_MAX];
+    int inside[BVH_STACK_MAX];
+    int top = 0;
+    stack[top] = 0;
+    inside[top] = 0;
+    ++top;
+
+    while (top > 0) {
+        --top;
+        const bvh_node_t* n = &bvh->nodes[stack[top]];
+        int fully_inside = inside[top];
+
+        float pixels = FLT_MAX;
+        int cls = classify_box(n, mvp, width, height, &pixels);
+        if (!fully_inside && cls < 0) continue;
+        if (pixels < min_pixels) continue;
+        if (cls > 0) fully_inside = 1;
+
+        if (n->left < 0) {
+            visit(&bvh->edge_index[n->first], n->count, user);
+            continue;
+        }
+        if (top + 2 > BVH_STACK_MAX) {
+            // Deeper than the stack allows (e.g. a foreign file): the subtree's
+            // edges are contiguous, so hand them over without further culling
+            visit(&bvh->edge_index[n->first], n->count, user);
+            continue;
+        }
+        stack[top] = n->right; inside[top] = fully_inside; ++top;
+        stack[top] = n->left;  inside[top] = fully_inside; ++top;
+    }
+}
+
+int bvh_save(const bvh_t* bvh, const char* filename) {
+    FILE* f = fopen(filename, "wb");
+    if (!f) return -1;
+    unsigned int header[4] = { BVH_MAGIC, BVH_VERSION,
+                               (unsigned int)bvh->node_count, (unsigned int)bvh->edge_count };
+    int ok = fwrite(header, sizeof(header), 1, f) == 1 &&
+             fwrite(bvh->nodes, sizeof(bvh_node_t), (size_t)bvh->node_count, f) == (size_t)bvh->node_count &&
+             fwrite(bvh->edge_index, sizeof(int), (size_t)bvh->edge_count, f) == (size_t)bvh->edge_count;
+    fclose(f);
+    return ok ? 0 : -1;
+}
+
+// Loaded trees are untrusted: every index bvh_traverse follows must stay in
+// range, children must come after their parent (so the walk terminates) and
+// edge_index must be a permutation of 0 .. edge_count-1
+static int bvh_valid(const bvh_t* bvh) {
+    if (bvh->edge_count == 0) return bvh->node_count == 0;
+    if (bvh->node_count < 1 || bvh->node_count > 2 * bvh->edge_count) return 0;
+
+    for (int i = 0; i < bvh->node_count; ++i) {
+        const bvh_node_t* n = &bvh->nodes[i];
+        if (n->first < 0 || n->count < 0 || n->count > bvh->edge_count - n->first) return 0;
+        if (n->left < 0 || n->right < 0) {
+            if (n->left != -1 || n->right != -1) return 0;
+        } else if (n->left <= i || n->right <= i ||
+                   n->left >= bvh->node_count || n->right >= bvh->node_count) {
+            return 0;
+        }
+    }
+
+    unsigned char* seen = calloc((size_t)bvh->edge_count, 1);
+    if (!seen) return 0;
+    int ok = 1;
+    for (int i = 0; i < bvh->edge_count && ok; ++i) {
+        int e = bvh->edge_index[i];
+        ok = e >= 0 && e < bvh->edge_count && !seen[e];
+        if (ok) seen[e] = 1;
+    }
+    free(seen);
+    return ok;
+}
+
+bvh_t* bvh_load(const char* filename) {
+    FILE* f = fopen(filename, "rb");
+    if (!f) return NULL;
+    unsigned int header[4];
+    if (fread(header, sizeof(header), 1, f) != 1 ||
+        header[0] != BVH_MAGIC || header[1] != BVH_VERSION ||
+        header[3] > INT_MAX / 2 || header[2] > 2 * header[3] + 1) {
+        fclose(f);
+        return NULL;
+    }
+
+    bvh_t* bvh = calloc(1, sizeof(bvh_t));
+    if (!bvh) { fclose(f); return NULL; }
+    bvh->node_count = (int)header[2];
+    bvh->edge_count = (int)header[3];
+    bvh->nodes = malloc((size_t)(bvh->node_count > 0 ? bvh->node_count : 1) * sizeof(bvh_node_t));
+    bvh->edge_index = malloc((size_t)(bvh->edge_count > 0 ? bvh->edge_count : 1) * sizeof(int));
+    int ok = bvh->nodes && bvh->edge_index &&
+             fread(bvh->nodes, sizeof(bvh_node_t), (size_t)bvh->node_count, f) == (size_t)bvh->node_count &&
+             fread(bvh->edge_index, sizeof(int), (size_t)bvh->edge_count, f) == (size_t)bvh->edge_count;
+    ok = ok && fgetc(f) == EOF;       // trailing bytes: not the file we wrote
+    fclose(f);
+    if (!ok || !bvh_valid(bvh)) {
+        bvh_destroy(bvh);
+        return NULL;
+    }
+    return bvh;
+}
@@ -1,20 +1,28 @@
 #include <stdlib.h>
 #include <stdio.h>
 #include <string.h>
+#include <stdint.h>
 #include "canvas.h"
 #include <math.h>
 
 canvas_t* canvas_create(int width, int height) {
+    if (width <= 0 || height <= 0 || (size_t)width > SIZE_MAX / sizeof(float) / (size_t)height)
+        return NULL;
     canvas_t* c = malloc(sizeof(canvas_t));
     if (!c) return NULL;
     c->width = width;
     c->height = height;
-    c->data = calloc(width * height, sizeof(float));
+    c->data = calloc((size_t)width * height, sizeof(float));
+    if (!c->data) {
+        free(c);
+        return NULL;
+    }
     return c;
 }
 
 void canvas_clear(canvas_t* c, float value) {
-    for (int i = 0; i < c->width * c->height; ++i) {
+    size_t n = (size_t)c->width * c->height;
+    for (size_t i = 0; i < n; ++i) {
         c->data[i] = value;
     }
 }
@@ -36,7 +44,7 @@ void set_pixel_f(canvas_t* c, float x, float y, float intensity) {
     int xi = (int)x;
     int yi = (int)y;
     if (xi >= 0 && xi < c->width && yi >= 0 && yi < c->height) {
-        int idx = yi * c->width + xi;
+        size_t idx = (size_t)yi * c->width + xi;
         if (intensity > c->data[idx]) {
             c->data[idx] = intensity;
         }
@@ -53,12 +61,61 @@ void draw_line_f(canvas_t* c, float x0, float y0, float x1, float y1, float inte
     }
 }
 
+// Samples like draw_line_f but only keeps pixels in [xmin, xmax) x [ymin, ymax);
+// canvas row 0 holds image row y_origin
+static void draw_line_window(canvas_t* c, float x0, float y0, float x1, float y1, float intensity,
+                             int xmin, int ymin, int xmax, int ymax, int y_origin) {
+    int steps = (int)(fmaxf(fabsf(x1 - x0), fabsf(y1 - y0))) * 2;
+    if (steps <= 0) return;
+
+    // Narrow the sample range to the rectangle (padded by a pixel for the
+    // truncation below), then sample exactly like draw_line_f
+    float lo = 0.0f, hi = 1.0f;
+    float p0[2] = { x0, y0 }, d[2] = { x1 - x0, y1 - y0 };
+    float rmin[2] = { xmin - 1.0f, ymin - 1.0f }, rmax[2] = { xmax + 1.0f, ymax + 1.0f };
+    for (int a = 0; a < 2; ++a) {
+        if (d[a] == 0.0f) {
+            if (p0[a] < rmin[a] || p0[a] > rmax[a]) return;
+            continue;
+        }
+        float ta = (rmin[a] - p0[a]) / d[a], tb = (rmax[a] - p0[a]) / d[a];
+        lo = fmaxf(lo, fminf(ta, tb));
+        hi = fminf(hi, fmaxf(ta, tb));
+    }
+    if (lo > hi) return;
+    int first = (int)floorf(lo * steps) - 1, last = (int)ceilf(hi * steps) + 1;
+    if (first < 0) first = 0;
+    if (last > steps) last = steps;
+
+    for (int i = first; i <= last; ++i) {
+        float t = (float)i / steps;
+        float x = x0 + (x1 - x0) * t;
+        float y = y0 + (y1 - y0) * t;
+        int xi = (int)x, yi = (int)y;
+        if (xi >= xmin && xi < xmax && yi >= ymin && yi < ymax) {
+            size_t idx = (size_t)(yi - y_origin) * c->width + xi;
+            if (intensity > c->data[idx]) c->data[idx] = intensity;
+        }
+    }
+}
+
+void draw_line_f_clipped(canvas_t* c, float x0, float y0, float x1, float y1, float intensity,
+                         int xmin, int ymin, int xmax, int ymax) {
+    draw_line_window(c, x0, y0, x1, y1, intensity, xmin, ymin, xmax, ymax, 0);
+}
+
+void draw_line_f_band(canvas_t* band, float x0, float y0, float x1, float y1, float intensity,
+                      int y_origin) {
+    draw_line_window(band, x0, y0, x1, y1, intensity,
+                     0, y_origin, band->width, y_origin + band->height, y_origin);
+}
+
 void canvas_to_pgm(canvas_t* c, const char* filename) {
     FILE* f = fopen(filename, "w");
     fprintf(f, "P2\n%d %d\n255\n", c->width, c->height);
     for (int y = 0; y < c->height; ++y) {
         for (int x = 0; x < c->width; ++x) {
-            float val = c->data[y * c->width + x];
+            float val = c->data[(size_t)y * c->width + x];
             int pixel = (int)(255.0f * fminf(fmaxf(val, 0.0f), 1.0f));
             fprintf(f, "%d ", pixel);
         }
@@ -66,3 +123,127 @@ void canvas_to_pgm(canvas_t* c, const char* filename) {
     }
     fclose(f);
 }
+
+canvas8_t* canvas8_create(int width, int height) {
+    canvas8_t* c = malloc(sizeof(canvas8_t));
+    if (!c) return NULL;
+    c->width = width;
+    c->height = height;
+    c->data = calloc((size_t)width * height, 1);
+    return c;
+}
+
+void canvas8_clear(canvas8_t* c, unsigned char value) {
+    memset(c->data, value, (size_t)c->width * c->height);
+}
+
+void canvas8_destroy(canvas8_t* c) {
+    if (c) {
+        free(c->data);
+        free(c);
+    }
+}
+
+void canvas8_to_pgm(canvas8_t* c, const char* filename) {
+    FILE* f = fopen(filename, "w");
+    fprintf(f, "P2\n%d %d\n255\n", c->width, c->height);
+    for (int y = 0; y < c->height; ++y) {
+        for (int x = 0; x < c->width; ++x) {
+            fprintf(f, "%d ", c->data[(size_t)y * c->width + x]);
+        }
+        fprintf(f, "\n");
+    }
+    fclose(f);
+}
+
+#define PGM_ROW_BLOCK 64
+
+typedef struct {
+    const canvas_t* c;
+    int y0;
+    char* text;          // PGM_ROW_BLOCK rows of (4 * width + 1) chars
+    int* lengths;
+} pgm_block_t;
+
+// Formats rows exactly like canvas_to_pgm's "%d " / "\n" output
+static void format_pgm_rows(void* ctx, int begin, int end) {
+    pgm_block_t* b = ctx;
+    const canvas_t* c = b->c;
+    size_t stride = (size_t)c->width * 4 + 1;
+    for (int r = begin; r < end; ++r) {
+        const float* row = c->data + (size_t)(b->y0 + r) * c->width;
+        char* out = b->text + (size_t)r * stride;
+        char* p = out;
+        for (int x = 0; x < c->width; ++x) {
+            int pixel = (int)(255.0f * fminf(fmaxf(row[x], 0.0f), 1.0f));
+            if (pixel >= 100) *p++ = (char)('0' + pixel / 100);
+            if (pixel >= 10)  *p++ = (char)('0' + pixel / 10 % 10);
+            *p++ = (char)('0' + pixel % 10);
+            *p++ = ' ';
+        }
+        *p++ = '\n';
+        b->lengths[r] = (int)(p - out);
+    }
+}
+
+void canvas_to_pgm_mt(job_system_t* js, canvas_t* c, const char* filename) {
+    size_t stride = (size_t)c->width * 4 + 1;
+    char* text = malloc(stride * PGM_ROW_BLOCK);
+    int lengths[PGM_ROW_BLOCK];
+    FILE* f = text ? fopen(filename, "w") : NULL;
+    if (!f) {
+        free(text);
+        canvas_to_pgm(c, filename);
+        return;
+    }
+
+    fprintf(f, "P2\n%d %d\n255\n", c->width, c->height);
+    for (int y = 0; y < c->height; y += PGM_ROW_BLOCK) {
+        int rows = c->height - y < PGM_ROW_BLOCK ? c->height - y : PGM_ROW_BLOCK;
+        pgm_block_t block = { c, y, text, lengths };
+        jobs_parallel_for(js, rows, 4, format_pgm_rows, &block);
+        for (int r = 0; r < rows; ++r)
+            fwrite(text + (size_t)r * stride, 1, (size_t)lengths[r], f);
+    }
+    fclose(f);
+    free(text);
+}
+
+pgm_writer_t* pgm_writer_open(const char* filename, int width, int height) {
+    if (width <= 0 || height <= 0) return NULL;
+    pgm_writer_t* w = calloc(1, sizeof(pgm_writer_t));
+    if (!w) return NULL;
+    w->width = width;
+    w->height = height;
+    w->row = malloc((size_t)width);
+    w->f = w->row ? fopen(filename, "wb") : NULL;
+    if (!w->f) {
+        free(w->row);
+        free(w);
+        return NULL;
+    }
+    fprintf(w->f, "P5\n%d %d\n255\n", width, height);
+    return w;
+}
+
+int pgm_writer_rows(pgm_writer_t* w, const canvas_t* band, int rows) {
+    if (band->width != w->width || rows < 0 || rows > band->height || rows > w->height - w->rows_written)
+        return -1;
+    for (int y = 0; y < rows; ++y) {
+        const float* src = band->data + (size_t)y * band->width;
+        for (int x = 0; x < w->width; ++x)
+            w->row[x] = (unsigned char)(int)(255.0f * fminf(fmaxf(src[x], 0.0f), 1.0f));
+        if (fwrite(w->row, 1, (size_t)w->width, w->f) != (size_t)w->width) return -1;
+    }
+    w->rows_written += rows;
+    return 0;
+}
+
+int pgm_writer_close(pgm_writer_t* w) {
+    if (!w) return -1;
+    int ok = w->rows_written == w->height;
+    if (fclose(w->f) != 0) ok = 0;
+    free(w->row);
+    free(w);
+    return ok ? 0 : -1;
+}
@@ -0,0 +1,348 @@
+#include "delta.h"
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <limits.h>
+#include <stdint.h>
+
+#define DELTA_MAGIC "T3DS"
+#define DELTA_VERSION 1u
+
+// RLE tokens: 0..127 = (t + 1) literal bytes follow, 128..255 = (t - 127) zeros
+#define RLE_MAX_RUN 128
+
+static void put_u32(unsigned char* p, unsigned int v) {
+    p[0] = v & 0xff; p[1] = (v >> 8) & 0xff; p[2] = (v >> 16) & 0xff; p[3] = (v >> 24) & 0xff;
+}
+
+static unsigned int get_u32(const unsigned char* p) {
+    return p[0] | (p[1] << 8) | (p[2] << 16) | ((unsigned int)p[3] << 24);
+}
+
+static size_t tiles_x(int width)  { return ((size_t)width  + DELTA_TILE - 1) / DELTA_TILE; }
+static size_t tiles_y(int height) { return ((size_t)height + DELTA_TILE - 1) / DELTA_TILE; }
+
+// Delta records start with one bit per tile
+static size_t mask_bytes(int width, int height) {
+    return (tiles_x(width) * tiles_y(height) + 7) / 8;
+}
+
+// Worst case is all literals: one token per RLE_MAX_RUN bytes
+static size_t payload_bound(int width, int height) {
+    size_t n = (size_t)width * height;
+    size_t tiles = tiles_x(width) * tiles_y(height);
+    return mask_bytes(width, height) + n + n / RLE_MAX_RUN + tiles + 16;
+}
+
+static size_t rle_encode(const unsigned char* src, size_t n, unsigned char* out) {
+    size_t o = 0, i = 0;
+    while (i < n) {
+        if (src[i] == 0) {
+            size_t run = 0;
+            while (i < n && src[i] == 0 && run < RLE_MAX_RUN) { ++i; ++run; }
+            out[o++] = (unsigned char)(127 + run);
+        } else {
+            size_t start = i, run = 0;
+            // Absorb single zeros into the literal; two or more start a zero run
+            while (i < n && run < RLE_MAX_RUN &&
+                   (src[i] != 0 || (i + 1 < n && src[i + 1] != 0))) { ++i; ++run; }
+            out[o++] = (unsigned char)(run - 1);
+            memcpy(out + o, src + start, run);
+            o += run;
+        }
+    }
+    return o;
+}
+
+// Adds decoded bytes onto dst (mod 256); returns bytes consumed or 0 on error
+static size_t rle_apply(const unsigned char* in, size_t in_len, unsigned char* dst, size_t n) {
+    size_t i = 0, o = 0;
+    while (o < n) {
+        if (i >= in_len) return 0;
+        unsigned char t = in[i++];
+        if (t >= 128) {
+            size_t run = t - 127;
+            if (o + run > n) return 0;
+            o += run;
+        } else {
+            size_t run = (size_t)t + 1;
+            if (o + run > n || i + run > in_len) return 0;
+            for (size_t k = 0; k < run; ++k) dst[o + k] = (unsigned char)(dst[o + k] + in[i + k]);
+            i += run;
+            o += run;
+        }
+    }
+    return i;
+}
+
+static void quantize(const canvas_t* c, unsigned char* out) {
+    size_t n = (size_t)c->width * c->height;
+    for (size_t i = 0; i < n; ++i) {
+        float val = c->data[i];
+        out[i] = (unsigned char)(255.0f * fminf(fmaxf(val, 0.0f), 1.0f));
+    }
+}
+
+// Copies one tile of a - b (mod 256) into out, row-major; returns pixel count
+static size_t tile_diff(const unsigned char* a, const unsigned char* b, int width, int height,
+                        size_t tx, size_t ty, unsigned char* out) {
+    size_t x0 = tx * DELTA_TILE, y0 = ty * DELTA_TILE;
+    size_t x1 = x0 + DELTA_TILE < (size_t)width  ? x0 + DELTA_TILE : (size_t)width;
+    size_t y1 = y0 + DELTA_TILE < (size_t)height ? y0 + DELTA_TILE : (size_t)height;
+    size_t k = 0;
+    for (size_t y = y0; y < y1; ++y) {
+        for (size_t x = x0; x < x1; ++x) {
+            size_t idx = y * width + x;
+            out[k++] = (unsigned char)(a[idx] - (b ? b[idx] : 0));
+        }
+    }
+    return k;
+}
+
+static void tile_add(unsigned char* dst, const unsigned char* diff, int width, int height,
+                     size_t tx, size_t ty) {
+    size_t x0 = tx * DELTA_TILE, y0 = ty * DELTA_TILE;
+    size_t x1 = x0 + DELTA_TILE < (size_t)width  ? x0 + DELTA_TILE : (size_t)width;
+    size_t y1 = y0 + DELTA_TILE < (size_t)height ? y0 + DELTA_TILE : (size_t)height;
+    size_t k = 0;
+    for (size_t y = y0; y < y1; ++y)
+        for (size_t x = x0; x < x1; ++x)
+            dst[y * width + x] = (unsigned char)(dst[y * width + x] + diff[k++]);
+}
+
+delta_writer_t* delta_writer_open(const char* filename, int width, int height, int keyframe_interval) {
+    if (width <= 0 || height <= 0 || (size_t)width > SIZE_MAX / 4 / (size_t)height) return NULL;
+    delta_writer_t* w = calloc(1, sizeof(delta_writer_t));
+    if (!w) return NULL;
+    size_t n = (size_t)width * height;
+    w->width = width;
+    w->height = height;
+    w->keyframe_interval = keyframe_interval;
+    w->prev = malloc(n ? n : 1);
+    w->cur = malloc(n ? n : 1);
+    w->payload = malloc(payload_bound(width, height));
+    w->file = fopen(filename, "wb");
+    if (!w->prev || !w->cur || !w->payload || !w->file) {
+        delta_writer_close(w);
+        return NULL;
+    }
+
+    unsigned char header[20];
+    memcpy(header, DELTA_MAGIC, 4);
+    put_u32(header + 4, DELTA_VERSION);
+    put_u32(header + 8, (unsigned int)width);
+    put_u32(header + 12, (unsigned int)height);
+    put_u32(header + 16, DELTA_TILE);
+    if (fwrite(header, sizeof(header), 1, w->file) != 1) {
+        delta_writer_close(w);
+        return NULL;
+    }
+    return w;
+}
+
+// Encodes w->cur against w->prev and appends the record
+static int write_current(delta_writer_t* w) {
+    int key = w->frame_count == 0 ||
+              (w->keyframe_interval > 0 && w->frame_count % w->keyframe_interval == 0);
+    size_t len = 0;
+
+    if (key) {
+        len = rle_encode(w->cur, (size_t)w->width * w->height, w->payload);
+    } else {
+        size_t tx = tiles_x(w->width), ty = tiles_y(w->height);
+        size_t mask_len = mask_bytes(w->width, w->height);
+        unsigned char diff[DELTA_TILE * DELTA_TILE];
+        memset(w->payload, 0, mask_len);
+        len = mask_len;
+        for (size_t y = 0; y < ty; ++y) {
+            for (size_t x = 0; x < tx; ++x) {
+                size_t n = tile_diff(w->cur, w->prev, w->width, w->height, x, y, diff);
+                size_t k = 0;
+                while (k < n && diff[k] == 0) ++k;
+                if (k == n) continue;
+                size_t t = y * tx + x;
+                w->payload[t / 8] |= (unsigned char)(1u << (t % 8));
+                len += rle_encode(diff, n, w->payload + len);
+            }
+        }
+    }
+
+    unsigned char record[5];
+    record[0] = key ? 'K' : 'D';
+    put_u32(record + 1, (unsigned int)len);
+    if (fwrite(record, sizeof(record), 1, w->file) != 1 ||
+        fwrite(w->payload, 1, len, w->file) != len)
+        return -1;
+
+    unsigned char* t = w->prev; w->prev = w->cur; w->cur = t;
+    w->frame_count++;
+    return 0;
+}
+
+int delta_writer_add(delta_writer_t* w, const canvas_t* c) {
+    if (c->width != w->width || c->height != w->height) return -1;
+    quantize(c, w->cur);
+    return write_current(w);
+}
+
+int delta_writer_add8(delta_writer_t* w, const canvas8_t* c) {
+    if (c->width != w->width || c->height != w->height) return -1;
+    memcpy(w->cur, c->data, (size_t)w->width * w->height);
+    return write_current(w);
+}
+
+void delta_writer_close(delta_writer_t* w) {
+    if (w) {
+        if (w->file) fclose(w->file);
+        free(w->prev);
+        free(w->cur);
+        free(w->payload);
+        free(w);
+    }
+}
+
+delta_reader_t* delta_reader_open(const char* filename) {
+    delta_reader_t* r = calloc(1, sizeof(delta_reader_t));
+    if (!r) return NULL;
+    r->decoded = -1;
+    r->file = fopen(filename, "rb");
+    unsigned char header[20];
+    if (!r->file || fread(header, sizeof(header), 1, r->file) != 1 ||
+        memcmp(header, DELTA_MAGIC, 4) != 0 || get_u32(header + 4) != DELTA_VERSION ||
+        get_u32(header + 16) != DELTA_TILE) {
+        delta_reader_close(r);
+        return NULL;
+    }
+    // The header is untrusted: keep width * height and payload_bound in range
+    unsigned int width = get_u32(header + 8), height = get_u32(header + 12);
+    if (width == 0 || height == 0 || width > INT_MAX || height > INT_MAX ||
+        (size_t)width > SIZE_MAX / 4 / height) {
+        delta_reader_close(r);
+        return NULL;
+    }
+    r->width = (int)width;
+    r->height = (int)height;
+
+    long file_size = -1;
+    if (fseek(r->file, 0, SEEK_END) == 0) file_size = ftell(r->file);
+    if (file_size < 0 || fseek(r->file, (long)sizeof(header), SEEK_SET) != 0) {
+        delta_reader_close(r);
+        return NULL;
+    }
+
+    // Index the record headers so any frame can be located without decoding.
+    // Indexing stops at the first record that is malformed or runs past the
+    // end of the file (e.g. a writer that was killed mid-frame).
+    int cap = 0;
+    size_t key_len = 0;
+    unsigned char record[5];
+    while (fread(record, sizeof(record), 1, r->file) == 1) {
+        long offset = ftell(r->file) - (long)sizeof(record);
+        size_t len = get_u32(record + 1);
+        if ((record[0] != 'K' && record[0] != 'D') || len > payload_bound(r->width, r->height) ||
+            (record[0] == 'D' && len < mask_bytes(r->width, r->height)) ||
+            len > (size_t)(file_size - offset - (long)sizeof(record)))
+            break;
+        if (r->frame_count == cap) {
+            cap = cap ? cap * 2 : 64;
+            long* offsets = realloc(r->offsets, (size_t)cap * sizeof(long));
+            unsigned char* types = realloc(r->types, (size_t)cap);
+            if (offsets) r->offsets = offsets;
+            if (types) r->types = types;
+            if (!offsets || !types) {
+                delta_reader_close(r);
+                return NULL;
+            }
+        }
+        if (r->frame_count == 0) key_len = len;
+        r->offsets[r->frame_count] = offset;
+        r->types[r->frame_count] = record[0];
+        r->frame_count++;
+        if (fseek(r->file, (long)len, SEEK_CUR) != 0) break;
+    }
+
+    // Each keyframe token byte expands to at most RLE_MAX_RUN pixels, so a
+    // keyframe shorter than n / RLE_MAX_RUN bytes means the dimensions lie
+    size_t n = (size_t)r->width * r->height;
+    if (r->frame_count == 0 || r->types[0] != 'K' || key_len < n / RLE_MAX_RUN) {
+        delta_reader_close(r);
+        return NULL;
+    }
+    r->pixels = malloc(n);
+    r->payload = malloc(payload_bound(r->width, r->height));
+    if (!r->pixels || !r->payload) {
+        delta_reader_close(r);
+        return NULL;
+    }
+    return r;
+}
+
+static int decode_record(delta_reader_t* r, int index) {
+    unsigned char record[5];
+    if (fseek(r->file, r->offsets[index], SEEK_SET) != 0 ||
+        fread(record, sizeof(record), 1, r->file) != 1)
+        return -1;
+    size_t len = get_u32(record + 1);
+    if (len > payload_bound(r->width, r->height) ||
+        fread(r->payload, 1, len, r->file) != len)
+        return -1;
+
+    size_t n = (size_t)r->width * r->height;
+    if (record[0] == 'K') {
+        memset(r->pixels, 0, n);
+        return rle_apply(r->payload, len, r->pixels, n) ? 0 : -1;
+    }
+
+    size_t tx = tiles_x(r->width), ty = tiles_y(r->height);
+    size_t pos = mask_bytes(r->width, r->height);
+    if (len < pos) return -1;    // too short for its tile mask
+    unsigned char diff[DELTA_TILE * DELTA_TILE];
+    for (size_t y = 0; y < ty; ++y) {
+        for (size_t x = 0; x < tx; ++x) {
+            size_t t = y * tx + x;
+            if (!(r->payload[t / 8] & (1u << (t % 8)))) continue;
+            size_t tw = (x + 1) * DELTA_TILE < (size_t)r->width  ? DELTA_TILE : r->width  - x * DELTA_TILE;
+            size_t th = (y + 1) * DELTA_TILE < (size_t)r->height ? DELTA_TILE : r->height - y * DELTA_TILE;
+            memset(diff, 0, sizeof(diff));
+            size_t used = pos < len ? rle_apply(r->payload + pos, len - pos, diff, tw * th) : 0;
+            if (!used) return -1;
+            pos += used;
+            tile_add(r->pixels, diff, r->width, r->height, x, y);
+        }
+    }
+    return 0;
+}
+
+int delta_reader_frame(delta_reader_t* r, int index, canvas_t* out) {
+    if (index < 0 || index >= r->frame_count ||
+        out->width != r->width || out->height != r->height)
+        return -1;
+
+    // Start from the nearest keyframe, or continue from the cached frame
+    int start = index;
+    while (r->types[start] != 'K') --start;
+    if (r->decoded >= start && r->decoded <= index) start = r->decoded + 1;
+
+    for (int i = start; i <= index; ++i) {
+        if (decode_record(r, i) != 0) {
+            r->decoded = -1;
+            return -1;
+        }
+        r->decoded = i;
+    }
+
+    size_t n = (size_t)r->width * r->height;
+    for (size_t i = 0; i < n; ++i) out->data[i] = r->pixels[i] / 255.0f;
+    return 0;
+}
+
+void delta_reader_close(delta_reader_t* r) {
+    if (r) {
+        if (r->file) fclose(r->file);
+        free(r->offsets);
+        free(r->types);
+        free(r->pixels);
+        free(r->payload);
+        free(r);
+    }
+}
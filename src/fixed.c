@@ -0,0 +1,243 @@
+#include "fixed.h"
+#include <stddef.h>
+
+#define RECIP_BITS 8
+#define RECIP_SIZE (1 << RECIP_BITS)
+
+// recip_table[i] = 1 / (1 + i/256) in Q16.16, plus one guard entry for
+// interpolation. Precomputed so fx_recip is safe to call from any thread.
+static const fx_t recip_table[RECIP_SIZE + 1] = {
+    65536, 65281, 65028, 64777, 64528, 64281, 64035, 63792,
+    63550, 63310, 63072, 62836, 62602, 62369, 62138, 61909,
+    61681, 61455, 61231, 61008, 60787, 60568, 60350, 60133,
+    59919, 59705, 59494, 59283, 59075, 58867, 58662, 58457,
+    58254, 58053, 57852, 57654, 57456, 57260, 57065, 56872,
+    56680, 56489, 56299, 56111, 55924, 55738, 55554, 55370,
+    55188, 55007, 54828, 54649, 54471, 54295, 54120, 53946,
+    53773, 53601, 53431, 53261, 53092, 52925, 52759, 52593,
+    52429, 52265, 52103, 51942, 51782, 51622, 51464, 51306,
+    51150, 50995, 50840, 50686, 50534, 50382, 50231, 50081,
+    49932, 49784, 49637, 49490, 49345, 49200, 49056, 48913,
+    48771, 48630, 48489, 48349, 48210, 48072, 47935, 47798,
+    47663, 47528, 47393, 47260, 47127, 46995, 46864, 46733,
+    46603, 46474, 46346, 46218, 46091, 45965, 45839, 45714,
+    45590, 45467, 45344, 45222, 45100, 44979, 44859, 44739,
+    44620, 44502, 44384, 44267, 44151, 44035, 43919, 43805,
+    43691, 43577, 43464, 43352, 43240, 43129, 43019, 42908,
+    42799, 42690, 42582, 42474, 42367, 42260, 42154, 42048,
+    41943, 41838, 41734, 41631, 41528, 41425, 41323, 41222,
+    41121, 41020, 40920, 40820, 40721, 40623, 40525, 40427,
+    40330, 40233, 40137, 40041, 39946, 39851, 39756, 39662,
+    39569, 39476, 39383, 39291, 39199, 39108, 39017, 38926,
+    38836, 38746, 38657, 38568, 38480, 38392, 38304, 38217,
+    38130, 38044, 37958, 37872, 37787, 37702, 37617, 37533,
+    37449, 37366, 37283, 37200, 37118, 37036, 36954, 36873,
+    36792, 36712, 36631, 36552, 36472, 36393, 36314, 36236,
+    36158, 36080, 36003, 35926, 35849, 35772, 35696, 35620,
+    35545, 35470, 35395, 35320, 35246, 35172, 35099, 35026,
+    34953, 34880, 34808, 34735, 34664, 34592, 34521, 34450,
+    34380, 34309, 34239, 34169, 34100, 34031, 33962, 33893,
+    33825, 33757, 33689, 33622, 33554, 33487, 33421, 33354,
+    33288, 33222, 33157, 33091, 33026, 32961, 32897, 32832,
+    32768
+};
+
+fx_t fx_recip(fx_t x) {
+    if (x == 0) return INT32_MAX;
+
+    int neg = x < 0;
+    uint32_t u = neg ? (uint32_t)(-(int64_t)x) : (uint32_t)x;
+
+    // Normalise to m in [1, 2) (Q16.16) so that x = m * 2^(p - 16)
+    int p = 31;
+    while (!(u & (1u << p))) --p;
+    uint32_t m = p >= FX_SHIFT ? u >> (p - FX_SHIFT) : u << (FX_SHIFT - p);
+
+    uint32_t idx = (m >> (FX_SHIFT - RECIP_BITS)) & (RECIP_SIZE - 1);
+    uint32_t frac = m & ((1u << (FX_SHIFT - RECIP_BITS)) - 1);
+    int32_t r0 = recip_table[idx], r1 = recip_table[idx + 1];
+    int64_t r = r0 + (((int64_t)(r1 - r0) * frac) >> (FX_SHIFT - RECIP_BITS));
+
+    // 1/x = r * 2^(16 - p)
+    if (p > FX_SHIFT) {
+        r >>= p - FX_SHIFT;
+    } else if (p < FX_SHIFT) {
+        int s = FX_SHIFT - p;
+        r = s >= 15 ? INT32_MAX : r << s;
+    }
+    if (r > INT32_MAX) r = INT32_MAX;
+    return neg ? (fx_t)-r : (fx_t)r;
+}
+
+static uint32_t isqrt64(uint64_t v) {
+    uint64_t res = 0, bit = (uint64_t)1 << 62;
+    while (bit > v) bit >>= 2;
+    while (bit) {
+        if (v >= res + bit) {
+            v -= res + bit;
+            res = (res >> 1) + bit;
+        } else {
+            res >>= 1;
+        }
+        bit >>= 2;
+    }
+    return (uint32_t)res;
+}
+
+fx_t fx_sqrt(fx_t x) {
+    if (x <= 0) return 0;
+    return (fx_t)isqrt64((uint64_t)x << FX_SHIFT);
+}
+
+vec3_fx_t vec3_to_fx(vec3_t v) {
+    return (vec3_fx_t){ fx_from_float(v.x), fx_from_float(v.y), fx_from_float(v.z) };
+}
+
+void mat4_to_fx(mat4_fx_t* out, const mat4_t* m) {
+    for (int i = 0; i < 16; ++i) out->m[i] = fx_from_float(m->m[i]);
+}
+
+void mat4_fx_multiply(mat4_fx_t* out, const mat4_fx_t* a, const mat4_fx_t* b) {
+    mat4_fx_t r;
+    for (int row = 0; row < 4; ++row) {
+        for (int col = 0; col < 4; ++col) {
+            int64_t acc = 0;
+            for (int k = 0; k < 4; ++k)
+                acc += (int64_t)a->m[row + k*4] * b->m[k + col*4];
+            r.m[row + col*4] = (fx_t)(acc >> FX_SHIFT);
+        }
+    }
+    *out = r;
+}
+
+// out = m * (v, 1), accumulated in 64 bits and rounded once
+static void mat4_fx_apply(const mat4_fx_t* m, vec3_fx_t v, fx_t out[4]) {
+    for (int i = 0; i < 4; ++i) {
+        int64_t acc = (int64_t)m->m[0*4 + i] * v.x + (int64_t)m->m[1*4 + i] * v.y +
+                      (int64_t)m->m[2*4 + i] * v.z + (int64_t)m->m[3*4 + i] * FX_ONE;
+        out[i] = (fx_t)(acc >> FX_SHIFT);
+    }
+}
+
+// Truncates towards zero like the float path's (int) casts
+static inline int fx_trunc(fx_t a) {
+    return a >= 0 ? a >> FX_SHIFT : -((-a) >> FX_SHIFT);
+}
+
+static inline fx_t fx_abs(fx_t a) {
+    return a < 0 ? -a : a;
+}
+
+static inline int fx_coord_ok(int64_t v) {
+    return v > -FX_COORD_LIMIT && v < FX_COORD_LIMIT;
+}
+
+void draw_line_fx(canvas8_t* c, fx_t x0, fx_t y0, fx_t x1, fx_t y1, unsigned char intensity) {
+    if (!fx_coord_ok(x0) || !fx_coord_ok(y0) || !fx_coord_ok(x1) || !fx_coord_ok(y1)) return;
+    fx_t dx = x1 - x0, dy = y1 - y0;
+    fx_t len = fx_abs(dx) > fx_abs(dy) ? fx_abs(dx) : fx_abs(dy);
+    int steps = (len >> FX_SHIFT) * 2;
+    if (steps == 0) return;
+
+    fx_t xinc = dx / steps, yinc = dy / steps;
+    fx_t x = x0, y = y0;
+    for (int i = 0; i <= steps; ++i, x += xinc, y += yinc) {
+        int xi = fx_trunc(x), yi = fx_trunc(y);
+        if (xi >= 0 && xi < c->width && yi >= 0 && yi < c->height) {
+            unsigned char* p = &c->data[(size_t)yi * c->width + xi];
+            if (intensity > *p) *p = intensity;
+        }
+    }
+}
+
+// Screen position in 64-bit Q16.16 so vertices near w = 0 (where fx_recip
+// saturates) can't wrap; z is clamped to a range the attenuation can square
+static void project_vertex_fx(const canvas8_t* c, vec3_fx_t v, const mat4_fx_t* mvp,
+                              int64_t* x, int64_t* y, fx_t* z) {
+    fx_t clip[4];
+    mat4_fx_apply(mvp, v, clip);
+    if (clip[3] == 0) {
+        *x = *y = *z = 0;
+        return;
+    }
+    int64_t rw = fx_recip(clip[3]);
+    int64_t ndc_x = (clip[0] * rw) >> FX_SHIFT;
+    int64_t ndc_y = (clip[1] * rw) >> FX_SHIFT;
+    int64_t ndc_z = (clip[2] * rw) >> FX_SHIFT;
+    *x = ((ndc_x + FX_ONE) * c->width) >> 1;
+    *y = ((FX_ONE - ndc_y) * c->height) >> 1;
+    *z = (fx_t)(ndc_z < -FX_Z_LIMIT ? -FX_Z_LIMIT : ndc_z > FX_Z_LIMIT ? FX_Z_LIMIT : ndc_z);
+}
+
+// Pulls (*x, *y) back along the segment towards the in-range point (ox, oy)
+// until it fits draw_line_fx's coordinate range; 0 if neither end fits
+static int fit_endpoint(int64_t* x, int64_t* y, int64_t ox, int64_t oy) {
+    if (fx_coord_ok(*x) && fx_coord_ok(*y)) return 1;
+    if (!fx_coord_ok(ox) || !fx_coord_ok(oy)) return 0;
+    // Bisect between the inside point and the outside one
+    int64_t ix = ox, iy = oy, px = *x, py = *y;
+    while (px - ix > 1 || ix - px > 1 || py - iy > 1 || iy - py > 1) {
+        int64_t mx = ix + (px - ix) / 2, my = iy + (py - iy) / 2;
+        if (fx_coord_ok(mx) && fx_coord_ok(my)) { ix = mx; iy = my; }
+        else { px = mx; py = my; }
+    }
+    *x = ix;
+    *y = iy;
+    return 1;
+}
+
+static vec3_fx_t vec3_fx_normalize(vec3_fx_t v) {
+    int64_t len2 = (int64_t)v.x * v.x + (int64_t)v.y * v.y + (int64_t)v.z * v.z;
+    fx_t len = (fx_t)isqrt64((uint64_t)len2);
+    if (len == 0) return v;
+    fx_t inv = fx_recip(len);
+    return (vec3_fx_t){ fx_mul(v.x, inv), fx_mul(v.y, inv), fx_mul(v.z, inv) };
+}
+
+static fx_t lambert_multi_fx(vec3_fx_t dir, const vec3_fx_t* lights, int count) {
+    // lambert_multi's 0/0 is NaN, which its fminf turns into full intensity
+    if (count <= 0) return FX_ONE;
+    int64_t total = 0;
+    for (int i = 0; i < count; ++i) {
+        int64_t dot = ((int64_t)dir.x * lights[i].x + (int64_t)dir.y * lights[i].y +
+                       (int64_t)dir.z * lights[i].z) >> FX_SHIFT;
+        if (dot > 0) total += dot;
+    }
+    total /= count;
+    return total < FX_ONE ? (fx_t)total : FX_ONE;
+}
+
+void render_wireframe_lit_fx(canvas8_t* canvas,
+                             const vec3_fx_t* vertices, const int edges[][2],
+                             int vcount, int ecount,
+                             const mat4_fx_t* model, const mat4_fx_t* view, const mat4_fx_t* proj,
+                             const vec3_fx_t* lights, int light_count,
+                             fx_t ambient) {
+    (void)vcount;
+    mat4_fx_t mv, mvp;
+    mat4_fx_multiply(&mv, view, model);
+    mat4_fx_multiply(&mvp, proj, &mv);
+
+    for (int i = 0; i < ecount; ++i) {
+        int a = edges[i][0], b = edges[i][1];
+        int64_t x0, y0, x1, y1;
+        fx_t z0, z1;
+        project_vertex_fx(canvas, vertices[a], &mvp, &x0, &y0, &z0);
+        project_vertex_fx(canvas, vertices[b], &mvp, &x1, &y1, &z1);
+        if (!fit_endpoint(&x0, &y0, x1, y1) || !fit_endpoint(&x1, &y1, x0, y0)) continue;
+
+        fx_t wa[4], wb[4];
+        mat4_fx_apply(model, vertices[a], wa);
+        mat4_fx_apply(model, vertices[b], wb);
+
+        vec3_fx_t dir = vec3_fx_normalize((vec3_fx_t){ wb[0] - wa[0], wb[1] - wa[1], wb[2] - wa[2] });
+        fx_t shade = lambert_multi_fx(dir, lights, light_count);
+        fx_t dz = (z0 + z1) >> 1;
+        fx_t attenuation = fx_recip(FX_ONE + (fx_mul(dz, dz) >> 1));
+        fx_t final = fx_mul(ambient + fx_mul(FX_ONE - ambient, shade), attenuation);
+
+        if (final < 0) final = 0;
+        if (final > FX_ONE) final = FX_ONE;
+        draw_line_fx(canvas, (fx_t)x0, (fx_t)y0, (fx_t)x1, (fx_t)y1, (unsigned char)(((int64_t)final * 255) >> FX_SHIFT));
+    }
+}
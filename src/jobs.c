@@ -0,0 +1,346 @@
+#include "jobs.h"
+#include <stdlib.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include <sched.h>
+#include <unistd.h>
+
+#define DEQUE_CAPACITY 1024          // power of two
+#define SPIN_ROUNDS 64
+#define CHUNKS_PER_THREAD 4
+
+// One jobs_parallel_for call; lives on the submitter's stack
+typedef struct {
+    atomic_int pending;              // chunks not yet finished
+    int sleeper;                     // submitter blocks on done instead of helping
+    int finished;                    // set under lock by the last chunk
+    pthread_mutex_t lock;
+    pthread_cond_t done;
+} batch_t;
+
+typedef struct job {
+    job_range_fn fn;
+    void* ctx;
+    int begin, end;
+    batch_t* batch;
+    struct job* next;                // injection queue link
+} job_t;
+
+// Chase-Lev deque (Le et al., "Correct and Efficient Work-Stealing for
+// Weak Memory Models"): the owner pushes/takes at the bottom, thieves steal
+// from the top. Fixed capacity; a full deque makes the owner run inline.
+typedef struct {
+    atomic_long top, bottom;
+    _Atomic(job_t*) buffer[DEQUE_CAPACITY];
+} deque_t;
+
+typedef struct {
+    job_system_t* js;
+    int index;
+    unsigned int rng;
+    pthread_t thread;
+    deque_t deque;
+} worker_t;
+
+struct job_system {
+    int worker_count;
+    worker_t* workers;
+
+    // Jobs submitted by threads outside the pool
+    pthread_mutex_t inject_lock;
+    job_t *inject_head, *inject_tail;
+    atomic_int injected;             // lets idle threads skip the lock
+
+    // Threads outside the pool share one seat: the holder helps run jobs
+    // like a worker, everyone else sleeps until their loop is done, so at
+    // most worker_count + 1 threads ever run jobs
+    atomic_int seat_taken;
+
+    atomic_int queued;               // jobs pushed but not yet taken
+    atomic_int sleeping;
+    atomic_int shutdown;
+    pthread_mutex_t sleep_lock;
+    pthread_cond_t wake;
+};
+
+static _Thread_local worker_t* current_worker = NULL;
+static _Thread_local job_system_t* seated_in = NULL;   // pool whose seat this thread holds
+
+static int deque_push(deque_t* d, job_t* job) {
+    long b = atomic_load_explicit(&d->bottom, memory_order_relaxed);
+    long t = atomic_load_explicit(&d->top, memory_order_acquire);
+    if (b - t >= DEQUE_CAPACITY) return 0;
+    atomic_store_explicit(&d->buffer[b & (DEQUE_CAPACITY - 1)], job, memory_order_relaxed);
+    atomic_store_explicit(&d->bottom, b + 1, memory_order_release);   // publishes the job
+    return 1;
+}
+
+static job_t* deque_take(deque_t* d) {
+    long b = atomic_load_explicit(&d->bottom, memory_order_relaxed) - 1;
+    atomic_store_explicit(&d->bottom, b, memory_order_relaxed);
+    atomic_thread_fence(memory_order_seq_cst);
+    long t = atomic_load_explicit(&d->top, memory_order_relaxed);
+
+    job_t* job = NULL;
+    if (t <= b) {
+        job = atomic_load_explicit(&d->buffer[b & (DEQUE_CAPACITY - 1)], memory_order_relaxed);
+        if (t == b) {
+            // Last element: race against thieves for it
+            if (!atomic_compare_exchange_strong_explicit(&d->top, &t, t + 1,
+                                                         memory_order_seq_cst, memory_order_relaxed))
+                job = NULL;
+            atomic_store_explicit(&d->bottom, b + 1, memory_order_relaxed);
+        }
+    } else {
+        atomic_store_explicit(&d->bottom, b + 1, memory_order_relaxed);
+    }
+    return job;
+}
+
+static job_t* deque_steal(deque_t* d) {
+    long t = atomic_load_explicit(&d->top, memory_order_acquire);
+    atomic_thread_fence(memory_order_seq_cst);
+    long b = atomic_load_explicit(&d->bottom, memory_order_acquire);
+    if (t >= b) return NULL;
+
+    job_t* job = atomic_load_explicit(&d->buffer[t & (DEQUE_CAPACITY - 1)], memory_order_relaxed);
+    if (!atomic_compare_exchange_strong_explicit(&d->top, &t, t + 1,
+                                                 memory_order_seq_cst, memory_order_relaxed))
+        return NULL;
+    return job;
+}
+
+static job_t* inject_pop(job_system_t* js) {
+    if (atomic_load_explicit(&js->injected, memory_order_relaxed) == 0) return NULL;
+    pthread_mutex_lock(&js->inject_lock);
+    job_t* job = js->inject_head;
+    if (job) {
+        js->inject_head = job->next;
+        if (!js->inject_head) js->inject_tail = NULL;
+        atomic_fetch_sub_explicit(&js->injected, 1, memory_order_relaxed);
+    }
+    pthread_mutex_unlock(&js->inject_lock);
+    return job;
+}
+
+static void notify(job_system_t* js, int count) {
+    atomic_fetch_add(&js->queued, count);
+    if (atomic_load(&js->sleeping) > 0) {
+        pthread_mutex_lock(&js->sleep_lock);
+        pthread_cond_broadcast(&js->wake);
+        pthread_mutex_unlock(&js->sleep_lock);
+    }
+}
+
+// self may be NULL for threads outside the pool
+static job_t* find_job(job_system_t* js, worker_t* self) {
+    job_t* job = self ? deque_take(&self->deque) : NULL;
+    if (!job) job = inject_pop(js);
+    if (!job && js->worker_count > 0) {
+        unsigned int start;
+        if (self) {
+            self->rng ^= self->rng << 13;
+            self->rng ^= self->rng >> 17;
+            self->rng ^= self->rng << 5;
+            start = self->rng;
+        } else {
+            start = (unsigned int)atomic_load_explicit(&js->queued, memory_order_relaxed);
+        }
+        for (int i = 0; i < js->worker_count && !job; ++i) {
+            worker_t* victim = &js->workers[(start + i) % js->worker_count];
+            if (victim != self) job = deque_steal(&victim->deque);
+        }
+    }
+    if (job) atomic_fetch_sub(&js->queued, 1);
+    return job;
+}
+
+static void run_job(job_t* job) {
+    batch_t* b = job->batch;
+    int sleeper = b->sleeper;        // a helper's batch may be gone after the decrement
+    job->fn(job->ctx, job->begin, job->end);
+    if (atomic_fetch_sub_explicit(&b->pending, 1, memory_order_acq_rel) == 1 && sleeper) {
+        // The submitter may free b as soon as it sees finished, so set it
+        // last and under the lock
+        pthread_mutex_lock(&b->lock);
+        b->finished = 1;
+        pthread_cond_signal(&b->done);
+        pthread_mutex_unlock(&b->lock);
+    }
+}
+
+static void* worker_main(void* arg) {
+    worker_t* self = arg;
+    job_system_t* js = self->js;
+    current_worker = self;
+
+    while (!atomic_load(&js->shutdown)) {
+        job_t* job = NULL;
+        for (int spin = 0; spin < SPIN_ROUNDS && !job; ++spin) {
+            job = find_job(js, self);
+            if (!job && atomic_load_explicit(&js->queued, memory_order_relaxed) == 0) break;
+        }
+        if (job) {
+            run_job(job);
+            continue;
+        }
+
+        pthread_mutex_lock(&js->sleep_lock);
+        atomic_fetch_add(&js->sleeping, 1);
+        if (atomic_load(&js->queued) == 0 && !atomic_load(&js->shutdown))
+            pthread_cond_wait(&js->wake, &js->sleep_lock);
+        atomic_fetch_sub(&js->sleeping, 1);
+        pthread_mutex_unlock(&js->sleep_lock);
+    }
+    return NULL;
+}
+
+job_system_t* jobs_create(int threads) {
+    if (threads <= 0) {
+        long n = sysconf(_SC_NPROCESSORS_ONLN);
+        threads = n > 0 ? (int)n : 1;
+    }
+
+    job_system_t* js = calloc(1, sizeof(job_system_t));
+    if (!js) return NULL;
+    js->worker_count = threads - 1;
+    js->workers = calloc(js->worker_count > 0 ? js->worker_count : 1, sizeof(worker_t));
+    if (!js->workers) {
+        free(js);
+        return NULL;
+    }
+    pthread_mutex_init(&js->inject_lock, NULL);
+    pthread_mutex_init(&js->sleep_lock, NULL);
+    pthread_cond_init(&js->wake, NULL);
+
+    for (int i = 0; i < js->worker_count; ++i) {
+        worker_t* w = &js->workers[i];
+        w->js = js;
+        w->index = i;
+        w->rng = 2463534242u + 977u * i;
+        if (pthread_create(&w->thread, NULL, worker_main, w) != 0) {
+            js->worker_count = i;    // run with the workers we got
+            break;
+        }
+    }
+    return js;
+}
+
+void jobs_destroy(job_system_t* js) {
+    if (!js) return;
+    pthread_mutex_lock(&js->sleep_lock);
+    atomic_store(&js->shutdown, 1);
+    pthread_cond_broadcast(&js->wake);
+    pthread_mutex_unlock(&js->sleep_lock);
+
+    for (int i = 0; i < js->worker_count; ++i)
+        pthread_join(js->workers[i].thread, NULL);
+
+    pthread_cond_destroy(&js->wake);
+    pthread_mutex_destroy(&js->sleep_lock);
+    pthread_mutex_destroy(&js->inject_lock);
+    free(js->workers);
+    free(js);
+}
+
+int jobs_thread_count(const job_system_t* js) {
+    return js ? js->worker_count + 1 : 1;
+}
+
+void jobs_parallel_for(job_system_t* js, int count, int grain, job_range_fn fn, void* ctx) {
+    if (count <= 0) return;
+    if (!js || js->worker_count == 0) {
+        fn(ctx, 0, count);
+        return;
+    }
+
+    if (grain <= 0) {
+        grain = count / (jobs_thread_count(js) * CHUNKS_PER_THREAD);
+        if (grain < 1) grain = 1;
+    }
+    int chunks = (count + grain - 1) / grain;
+
+    worker_t* self = current_worker && current_worker->js == js ? current_worker : NULL;
+    int seated = 0;
+    if (!self && seated_in != js) {
+        int expected = 0;
+        seated = atomic_compare_exchange_strong(&js->seat_taken, &expected, 1);
+        if (seated) seated_in = js;
+    }
+    int helper = self || seated_in == js;
+    if (chunks == 1 && helper) {
+        fn(ctx, 0, count);
+        goto release;
+    }
+
+    job_t* jobs = malloc((size_t)chunks * sizeof(job_t));
+    if (!jobs) {
+        fn(ctx, 0, count);
+        goto release;
+    }
+    batch_t batch;
+    atomic_init(&batch.pending, chunks);
+    batch.sleeper = !helper;
+    batch.finished = 0;
+    if (!helper) {
+        pthread_mutex_init(&batch.lock, NULL);
+        pthread_cond_init(&batch.done, NULL);
+    }
+    for (int i = 0; i < chunks; ++i) {
+        jobs[i].fn = fn;
+        jobs[i].ctx = ctx;
+        jobs[i].begin = i * grain;
+        jobs[i].end = i * grain + grain < count ? i * grain + grain : count;
+        jobs[i].batch = &batch;
+        jobs[i].next = &jobs[i + 1];
+    }
+    jobs[chunks - 1].next = NULL;
+
+    // Helpers keep the first chunk for themselves; a sleeper hands over all
+    int first = helper ? 1 : 0;
+    if (self) {
+        // Overflow runs inline
+        int pushed = 0;
+        for (int i = first; i < chunks; ++i) {
+            if (deque_push(&self->deque, &jobs[i])) {
+                ++pushed;
+            } else {
+                if (pushed) notify(js, pushed);
+                pushed = 0;
+                run_job(&jobs[i]);
+            }
+        }
+        if (pushed) notify(js, pushed);
+    } else {
+        pthread_mutex_lock(&js->inject_lock);
+        if (js->inject_tail) js->inject_tail->next = &jobs[first];
+        else js->inject_head = &jobs[first];
+        js->inject_tail = &jobs[chunks - 1];
+        atomic_fetch_add_explicit(&js->injected, chunks - first, memory_order_relaxed);
+        pthread_mutex_unlock(&js->inject_lock);
+        notify(js, chunks - first);
+    }
+
+    if (helper) {
+        run_job(&jobs[0]);
+        // Help out until every chunk of this loop has finished
+        while (atomic_load_explicit(&batch.pending, memory_order_acquire) > 0) {
+            job_t* job = find_job(js, self);
+            if (job) run_job(job);
+            else sched_yield();
+        }
+    } else {
+        pthread_mutex_lock(&batch.lock);
+        while (!batch.finished) pthread_cond_wait(&batch.done, &batch.lock);
+        pthread_mutex_unlock(&batch.lock);
+        pthread_cond_destroy(&batch.done);
+        pthread_mutex_destroy(&batch.lock);
+    }
+    free(jobs);
+
+release:
+    if (seated) {
+        seated_in = NULL;
+        atomic_store(&js->seat_taken, 0);
+    }
+}
@@ -0,0 +1,184 @@
+#include "raster.h"
+#include <math.h>
+#include <stddef.h>
+
+#if defined(__SSE2__) && !defined(TINY3D_NO_SIMD)
+#include <emmintrin.h>
+#define RASTER_SSE2 1
+#endif
+
+// Edge function w(x, y) = a*x + b*y + c, positive inside
+typedef struct {
+    float a[3], b[3], c[3];
+    int top_left[3];
+    float za, zb, zc;            // depth plane z(x, y) = za*x + zb*y + zc
+    float intensity;
+} tri_setup_t;
+
+static void setup_edge(tri_setup_t* t, int i, float ax, float ay, float bx, float by) {
+    // Derive the coefficients from the endpoints in a fixed order, so a
+    // shared edge gets exactly negated values in both triangles and the
+    // fill rule can't round the same pixel into both
+    int flip = ay > by || (ay == by && ax > bx);
+    float ux = flip ? bx : ax, uy = flip ? by : ay;
+    float vx = flip ? ax : bx, vy = flip ? ay : by;
+    float a = uy - vy, b = vx - ux, c = -(a * ux + b * uy);
+    t->a[i] = flip ? -a : a;
+    t->b[i] = flip ? -b : b;
+    t->c[i] = flip ? -c : c;
+    // With y pointing down: top edges run +x, left edges run upwards
+    t->top_left[i] = t->a[i] > 0.0f || (t->a[i] == 0.0f && t->b[i] > 0.0f);
+}
+
+static inline int edge_inside(const tri_setup_t* t, int i, float px, float py) {
+    float w = t->a[i] * px + (t->b[i] * py + t->c[i]);
+    return w > 0.0f || (w == 0.0f && t->top_left[i]);
+}
+
+static inline void shade_pixel(const tri_setup_t* t, canvas_t* c, canvas_t* depth,
+                               size_t idx, float px, float py) {
+    if (depth) {
+        float z = t->za * px + (t->zb * py + t->zc);
+        if (!(z < depth->data[idx])) return;
+        depth->data[idx] = z;
+    }
+    c->data[idx] = t->intensity;
+}
+
+// Per-pixel path for blocks that hang over the canvas border (and for
+// builds without SSE2)
+static void block_scalar(const tri_setup_t* t, canvas_t* c, canvas_t* depth,
+                         int bx, int by, int test_edges) {
+    int x1 = bx + RASTER_BLOCK < c->width  ? bx + RASTER_BLOCK : c->width;
+    int y1 = by + RASTER_BLOCK < c->height ? by + RASTER_BLOCK : c->height;
+    for (int y = by; y < y1; ++y) {
+        float py = (float)y + 0.5f;
+        for (int x = bx; x < x1; ++x) {
+            float px = (float)x + 0.5f;
+            if (test_edges && !(edge_inside(t, 0, px, py) && edge_inside(t, 1, px, py) &&
+                                edge_inside(t, 2, px, py)))
+                continue;
+            shade_pixel(t, c, depth, (size_t)y * c->width + x, px, py);
+        }
+    }
+}
+
+#ifdef RASTER_SSE2
+// Same arithmetic as block_scalar, four pixels at a time
+static void block_sse2(const tri_setup_t* t, canvas_t* c, canvas_t* depth,
+                       int bx, int by, int test_edges) {
+    const __m128 zero = _mm_setzero_ps();
+    __m128 a[3], za = _mm_set1_ps(t->za), value = _mm_set1_ps(t->intensity);
+    for (int i = 0; i < 3; ++i) a[i] = _mm_set1_ps(t->a[i]);
+
+    for (int r = 0; r < RASTER_BLOCK; ++r) {
+        int y = by + r;
+        float py = (float)y + 0.5f;
+        __m128 zrow = _mm_set1_ps(t->zb * py + t->zc);
+        __m128 wrow[3];
+        for (int i = 0; i < 3; ++i) wrow[i] = _mm_set1_ps(t->b[i] * py + t->c[i]);
+
+        for (int h = 0; h < RASTER_BLOCK; h += 4) {
+            __m128 px = _mm_add_ps(_mm_set1_ps((float)(bx + h)), _mm_setr_ps(0.5f, 1.5f, 2.5f, 3.5f));
+            __m128 mask = _mm_castsi128_ps(_mm_set1_epi32(-1));
+            if (test_edges) {
+                for (int i = 0; i < 3; ++i) {
+                    __m128 w = _mm_add_ps(_mm_mul_ps(a[i], px), wrow[i]);
+                    mask = _mm_and_ps(mask, t->top_left[i] ? _mm_cmpge_ps(w, zero)
+                                                           : _mm_cmpgt_ps(w, zero));
+                }
+                if (_mm_movemask_ps(mask) == 0) continue;
+            }
+
+            size_t idx = (size_t)y * c->width + bx + h;
+            if (depth) {
+                __m128 z = _mm_add_ps(_mm_mul_ps(za, px), zrow);
+                __m128 d = _mm_loadu_ps(&depth->data[idx]);
+                mask = _mm_and_ps(mask, _mm_cmplt_ps(z, d));
+                _mm_storeu_ps(&depth->data[idx], _mm_or_ps(_mm_and_ps(mask, z), _mm_andnot_ps(mask, d)));
+            }
+            __m128 old = _mm_loadu_ps(&c->data[idx]);
+            _mm_storeu_ps(&c->data[idx], _mm_or_ps(_mm_and_ps(mask, value), _mm_andnot_ps(mask, old)));
+        }
+    }
+}
+#endif
+
+void fill_triangle_f(canvas_t* c, canvas_t* depth,
+                     float x0, float y0, float z0,
+                     float x1, float y1, float z1,
+                     float x2, float y2, float z2,
+                     float intensity) {
+    if (!isfinite(x0) || !isfinite(y0) || !isfinite(x1) || !isfinite(y1) ||
+        !isfinite(x2) || !isfinite(y2))
+        return;
+
+    float area = (x1 - x0) * (y2 - y0) - (y1 - y0) * (x2 - x0);
+    if (area == 0.0f) return;
+    if (area < 0.0f) {
+        // Accept either winding: swap to make the inside positive
+        float tx = x1, ty = y1, tz = z1;
+        x1 = x2; y1 = y2; z1 = z2;
+        x2 = tx; y2 = ty; z2 = tz;
+        area = -area;
+    }
+
+    tri_setup_t t;
+    setup_edge(&t, 0, x1, y1, x2, y2);   // opposite v0
+    setup_edge(&t, 1, x2, y2, x0, y0);   // opposite v1
+    setup_edge(&t, 2, x0, y0, x1, y1);   // opposite v2
+    t.za = (t.a[0] * z0 + t.a[1] * z1 + t.a[2] * z2) / area;
+    t.zb = (t.b[0] * z0 + t.b[1] * z1 + t.b[2] * z2) / area;
+    t.zc = (t.c[0] * z0 + t.c[1] * z1 + t.c[2] * z2) / area;
+    t.intensity = intensity;
+
+    int minx = (int)floorf(fmaxf(fminf(fminf(x0, x1), x2), 0.0f));
+    int miny = (int)floorf(fmaxf(fminf(fminf(y0, y1), y2), 0.0f));
+    int maxx = (int)ceilf(fminf(fmaxf(fmaxf(x0, x1), x2), (float)(c->width - 1)));
+    int maxy = (int)ceilf(fminf(fmaxf(fmaxf(y0, y1), y2), (float)(c->height - 1)));
+    if (minx > maxx || miny > maxy) return;
+
+    const float span = RASTER_BLOCK - 1;
+    for (int by = miny & ~(RASTER_BLOCK - 1); by <= maxy; by += RASTER_BLOCK) {
+        for (int bx = minx & ~(RASTER_BLOCK - 1); bx <= maxx; bx += RASTER_BLOCK) {
+            // Edge functions are linear, so the corner pixel centres bound the
+            // block; the margin keeps rounding from flipping a per-pixel verdict
+            float px = (float)bx + 0.5f, py = (float)by + 0.5f;
+            int outside = 0, inside = 1;
+            for (int i = 0; i < 3 && !outside; ++i) {
+                float w = t.a[i] * px + (t.b[i] * py + t.c[i]);
+                float dx = t.a[i] * span, dy = t.b[i] * span;
+                float wmin = w + fminf(dx, 0.0f) + fminf(dy, 0.0f);
+                float wmax = w + fmaxf(dx, 0.0f) + fmaxf(dy, 0.0f);
+                float margin = (fabsf(w) + fabsf(dx) + fabsf(dy) + fabsf(t.c[i])) * 1e-5f;
+                if (wmax < -margin) outside = 1;
+                if (wmin <= margin) inside = 0;
+            }
+            if (outside) continue;
+
+#ifdef RASTER_SSE2
+            if (bx + RASTER_BLOCK <= c->width && by + RASTER_BLOCK <= c->height) {
+                block_sse2(&t, c, depth, bx, by, !inside);
+                continue;
+            }
+#endif
+            block_scalar(&t, c, depth, bx, by, !inside);
+        }
+    }
+}
+
+void draw_line_depth_f(canvas_t* c, const canvas_t* depth,
+                       float x0, float y0, float z0,
+                       float x1, float y1, float z1,
+                       float intensity, float bias) {
+    int steps = (int)(fmaxf(fabsf(x1 - x0), fabsf(y1 - y0))) * 2;
+    if (steps <= 0) return;      // like draw_line_f, sub-pixel lines draw nothing
+    for (int i = 0; i <= steps; ++i) {
+        float t = (float)i / steps;
+        int xi = (int)(x0 + (x1 - x0) * t);
+        int yi = (int)(y0 + (y1 - y0) * t);
+        if (xi < 0 || xi >= c->width || yi < 0 || yi >= c->height) continue;
+        size_t idx = (size_t)yi * c->width + xi;
+        if (z0 + (z1 - z0) * t <= depth->data[idx] + bias) c->data[idx] = intensity;
+    }
+}
@@ -1,7 +1,10 @@
 #include "renderer.h"
 #include "lighting.h"
+#include "raster.h"
 #include "math3d.h"
 #include <math.h>
+#include <stdlib.h>
+#include <stdatomic.h>
 
 // Apply a 4x4 matrix to a 3D point (assumes w = 1.0)
 vec3_t vec3_transform(mat4_t m, vec3_t v) {
@@ -36,7 +39,7 @@ static void mat4_apply(const mat4_t* m, const float in[4], float out[4]) {
     }
 }
 
-static void project_vertex(canvas_t* c, vec3_t v,
+static void project_vertex(int width, int height, vec3_t v,
                            const mat4_t* model, const mat4_t* view, const mat4_t* proj,
                            float* x, float* y, float* z_out) {
     float p[4] = { v.x, v.y, v.z, 1.0f }, t1[4], t2[4], t3[4];
@@ -47,8 +50,8 @@ static void project_vertex(canvas_t* c, vec3_t v,
     if (t3[3] != 0.0f) {
         float ndc_x = t3[0] / t3[3];
         float ndc_y = t3[1] / t3[3];
-        *x = (ndc_x * 0.5f + 0.5f) * c->width;
-        *y = (1.0f - (ndc_y * 0.5f + 0.5f)) * c->height;
+        *x = (ndc_x * 0.5f + 0.5f) * width;
+        *y = (1.0f - (ndc_y * 0.5f + 0.5f)) * height;
         *z_out = t3[2] / t3[3];
     } else {
         *x = *y = *z_out = 0.0f;
@@ -63,8 +66,8 @@ void render_wireframe(canvas_t* c, vec3_t* vertices, int edges[][2],
     for (int i = 0; i < ecount; ++i) {
         int a = edges[i][0], b = edges[i][1];
         float x0, y0, z0, x1, y1, z1;
-        project_vertex(c, vertices[a], model, view, proj, &x0, &y0, &z0);
-        project_vertex(c, vertices[b], model, view, proj, &x1, &y1, &z1);
+        project_vertex(c->width, c->height, vertices[a], model, view, proj, &x0, &y0, &z0);
+        project_vertex(c->width, c->height, vertices[b], model, view, proj, &x1, &y1, &z1);
 
         vec3_t dir = vec3_normalize_fast(vec3_sub(vertices[b], vertices[a]));
         float intensity = lambert(dir, light_dir);
@@ -74,6 +77,37 @@ void render_wireframe(canvas_t* c, vec3_t* vertices, int edges[][2],
     }
 }
 
+// Lambert shading of a world-space edge, attenuated by its projected depth
+static float lit_intensity(const float wa[4], const float wb[4], float z0, float z1,
+                           const vec3_t* lights, int light_count, float ambient) {
+    vec3_t dir = vec3_normalize_fast(vec3_init(wb[0] - wa[0], wb[1] - wa[1], wb[2] - wa[2]));
+    float shade = lambert_multi(dir, lights, light_count);
+    float dz = (z0 + z1) * 0.5f;                         // average projected depth
+    float attenuation = 1.0f / (1.0f + 0.5f * dz * dz);   // tweak strength as needed
+    return (ambient + (1.0f - ambient) * shade) * attenuation;
+}
+
+// Projects, shades and draws a single edge of a lit wireframe
+static void draw_lit_edge(canvas_t* canvas, const vec3_t* vertices, const int edge[2],
+                          const mat4_t* model, const mat4_t* view, const mat4_t* proj,
+                          const vec3_t* lights, int light_count, float ambient) {
+    int a = edge[0], b = edge[1];
+    float x0, y0, z0, x1, y1, z1;
+
+    project_vertex(canvas->width, canvas->height, vertices[a], model, view, proj, &x0, &y0, &z0);
+    project_vertex(canvas->width, canvas->height, vertices[b], model, view, proj, &x1, &y1, &z1);
+
+    float pa[4] = { vertices[a].x, vertices[a].y, vertices[a].z, 1.0f };
+    float pb[4] = { vertices[b].x, vertices[b].y, vertices[b].z, 1.0f };
+    float wa[4], wb[4];
+
+    mat4_apply(model, pa, wa);
+    mat4_apply(model, pb, wb);
+
+    float final = lit_intensity(wa, wb, z0, z1, lights, light_count, ambient);
+    draw_line_f(canvas, x0, y0, x1, y1, final);
+}
+
 void render_wireframe_lit(canvas_t* canvas,
                           const vec3_t* vertices, const int edges[][2],
                           int vcount, int ecount,
@@ -81,26 +115,425 @@ void render_wireframe_lit(canvas_t* canvas,
                           const vec3_t* lights, int light_count,
                           float ambient) {
     (void)vcount;
+    for (int i = 0; i < ecount; ++i) {
+        draw_lit_edge(canvas, vertices, edges[i], model, view, proj,
+                      lights, light_count, ambient);
+    }
+}
+
+typedef struct {
+    canvas_t* canvas;
+    const vec3_t* vertices;
+    const int (*edges)[2];
+    const mat4_t *model, *view, *proj;
+    const vec3_t* lights;
+    int light_count;
+    float ambient;
+} lit_batch_t;
+
+static void draw_lit_leaf(const int* edge_ids, int count, void* user) {
+    const lit_batch_t* b = user;
+    for (int i = 0; i < count; ++i) {
+        draw_lit_edge(b->canvas, b->vertices, b->edges[edge_ids[i]], b->model, b->view, b->proj,
+                      b->lights, b->light_count, b->ambient);
+    }
+}
+
+void render_wireframe_lit_bvh(canvas_t* canvas, const bvh_t* bvh,
+                              const vec3_t* vertices, const int edges[][2], int ecount,
+                              const mat4_t* model, const mat4_t* view, const mat4_t* proj,
+                              const vec3_t* lights, int light_count,
+                              float ambient, float min_pixels) {
+    // A tree built (or loaded) for another edge list would index past edges[]
+    if (!bvh || bvh->edge_count != ecount) return;
+
+    mat4_t m = *model, v = *view, p = *proj, mv, mvp;
+    mat4_multiply(&mv, &v, &m);
+    mat4_multiply(&mvp, &p, &mv);
+
+    lit_batch_t batch = { canvas, vertices, edges, model, view, proj,
+                          lights, light_count, ambient };
+    bvh_traverse(bvh, &mvp, canvas->width, canvas->height, min_pixels, draw_lit_leaf, &batch);
+}
+
+#define RENDER_TILE 64
+
+typedef struct {
+    float x0, y0, x1, y1, intensity;
+    int tx0, ty0, tx1, ty1;      // inclusive tile range of the line's bounding box
+} edge_setup_t;
+
+typedef struct {
+    canvas_t* canvas;
+    const vec3_t* vertices;
+    const int (*edges)[2];
+    const mat4_t *model, *view, *proj;
+    const vec3_t* lights;
+    int light_count;
+    float ambient;
+
+    float* screen;               // x, y, z per vertex
+    float* world;                // 4 floats per vertex
+    edge_setup_t* setup;
+    int tiles_x, tiles_y;
+    atomic_int* cursor;          // per-tile counts, then fill positions
+    int* bin_start;              // tiles + 1 prefix offsets into bins
+    int* bins;
+} lit_frame_t;
+
+static void transform_vertices(void* ctx, int begin, int end) {
+    lit_frame_t* f = ctx;
+    for (int i = begin; i < end; ++i) {
+        vec3_t v = f->vertices[i];
+        float p[4] = { v.x, v.y, v.z, 1.0f };
+        float* s = &f->screen[(size_t)i * 3];
+        project_vertex(f->canvas->width, f->canvas->height, v, f->model, f->view, f->proj, &s[0], &s[1], &s[2]);
+        mat4_apply(f->model, p, &f->world[(size_t)i * 4]);
+    }
+}
+
+static int tile_of(float v, int size, int tiles) {
+    int t = (int)fminf(fmaxf(v, 0.0f), (float)size) / RENDER_TILE;
+    return t < tiles ? t : tiles - 1;
+}
+
+// Columns of tile row ty that the edge can touch: the x extent of the line
+// inside the row's slab, padded by a pixel like draw_line_f_clipped. The
+// outer rows extend to infinity since tile_of clamps off-canvas samples
+// into them. Walking rows this way bins a long diagonal into O(rows + cols)
+// tiles instead of its whole bounding box.
+static void edge_tile_span(const lit_frame_t* f, const edge_setup_t* e, int ty,
+                           int* tx0, int* tx1) {
+    float dy = e->y1 - e->y0;
+    float lo = 0.0f, hi = 1.0f;
+    if (dy != 0.0f && e->ty0 != e->ty1) {
+        float ymin = ty == e->ty0 ? -INFINITY : ty * (float)RENDER_TILE - 1.0f;
+        float ymax = ty == e->ty1 ? INFINITY : (ty + 1) * (float)RENDER_TILE + 1.0f;
+        float ta = (ymin - e->y0) / dy, tb = (ymax - e->y0) / dy;
+        lo = fmaxf(lo, fminf(ta, tb));
+        hi = fminf(hi, fmaxf(ta, tb));
+    }
+    float xa = e->x0 + (e->x1 - e->x0) * lo, xb = e->x0 + (e->x1 - e->x0) * hi;
+    *tx0 = tile_of(fminf(xa, xb) - 1.0f, f->canvas->width, f->tiles_x);
+    *tx1 = tile_of(fmaxf(xa, xb) + 1.0f, f->canvas->width, f->tiles_x);
+    if (*tx0 < e->tx0) *tx0 = e->tx0;
+    if (*tx1 > e->tx1) *tx1 = e->tx1;
+}
+
+static void setup_edges(void* ctx, int begin, int end) {
+    lit_frame_t* f = ctx;
+    for (int i = begin; i < end; ++i) {
+        int a = f->edges[i][0], b = f->edges[i][1];
+        const float* sa = &f->screen[(size_t)a * 3];
+        const float* sb = &f->screen[(size_t)b * 3];
+        edge_setup_t* e = &f->setup[i];
+
+        e->x0 = sa[0]; e->y0 = sa[1];
+        e->x1 = sb[0]; e->y1 = sb[1];
+        e->intensity = lit_intensity(&f->world[(size_t)a * 4], &f->world[(size_t)b * 4],
+                                     sa[2], sb[2], f->lights, f->light_count, f->ambient);
+        e->tx0 = tile_of(fminf(e->x0, e->x1), f->canvas->width, f->tiles_x);
+        e->tx1 = tile_of(fmaxf(e->x0, e->x1), f->canvas->width, f->tiles_x);
+        e->ty0 = tile_of(fminf(e->y0, e->y1), f->canvas->height, f->tiles_y);
+        e->ty1 = tile_of(fmaxf(e->y0, e->y1), f->canvas->height, f->tiles_y);
+
+        for (int ty = e->ty0; ty <= e->ty1; ++ty) {
+            int tx0, tx1;
+            edge_tile_span(f, e, ty, &tx0, &tx1);
+            for (int tx = tx0; tx <= tx1; ++tx)
+                atomic_fetch_add_explicit(&f->cursor[ty * f->tiles_x + tx], 1, memory_order_relaxed);
+        }
+    }
+}
+
+static void bin_edges(void* ctx, int begin, int end) {
+    lit_frame_t* f = ctx;
+    for (int i = begin; i < end; ++i) {
+        const edge_setup_t* e = &f->setup[i];
+        for (int ty = e->ty0; ty <= e->ty1; ++ty) {
+            int tx0, tx1;
+            edge_tile_span(f, e, ty, &tx0, &tx1);
+            for (int tx = tx0; tx <= tx1; ++tx) {
+                int slot = atomic_fetch_add_explicit(&f->cursor[ty * f->tiles_x + tx], 1,
+                                                     memory_order_relaxed);
+                f->bins[slot] = i;
+            }
+        }
+    }
+}
+
+// Each tile is owned by one job, so the max-blend writes never race
+static void raster_tiles(void* ctx, int begin, int end) {
+    lit_frame_t* f = ctx;
+    for (int t = begin; t < end; ++t) {
+        int xmin = (t % f->tiles_x) * RENDER_TILE, ymin = (t / f->tiles_x) * RENDER_TILE;
+        int xmax = xmin + RENDER_TILE < f->canvas->width  ? xmin + RENDER_TILE : f->canvas->width;
+        int ymax = ymin + RENDER_TILE < f->canvas->height ? ymin + RENDER_TILE : f->canvas->height;
+        for (int k = f->bin_start[t]; k < f->bin_start[t + 1]; ++k) {
+            const edge_setup_t* e = &f->setup[f->bins[k]];
+            draw_line_f_clipped(f->canvas, e->x0, e->y0, e->x1, e->y1, e->intensity,
+                                xmin, ymin, xmax, ymax);
+        }
+    }
+}
+
+void render_wireframe_lit_mt(job_system_t* js, canvas_t* canvas,
+                             const vec3_t* vertices, const int edges[][2],
+                             int vcount, int ecount,
+                             const mat4_t* model, const mat4_t* view, const mat4_t* proj,
+                             const vec3_t* lights, int light_count,
+                             float ambient) {
+    // Like render_wireframe_lit, trust the edges rather than vcount: only
+    // vertices up to the largest referenced index are transformed
+    (void)vcount;
+    int used = 0;
+    for (int i = 0; i < ecount; ++i) {
+        if (edges[i][0] >= used) used = edges[i][0] + 1;
+        if (edges[i][1] >= used) used = edges[i][1] + 1;
+    }
+
+    lit_frame_t f = { canvas, vertices, edges, model, view, proj, lights, light_count, ambient,
+                      NULL, NULL, NULL, 0, 0, NULL, NULL, NULL };
+    f.tiles_x = (canvas->width + RENDER_TILE - 1) / RENDER_TILE;
+    f.tiles_y = (canvas->height + RENDER_TILE - 1) / RENDER_TILE;
+    int tiles = f.tiles_x * f.tiles_y;
+
+    f.screen = malloc((size_t)(used > 0 ? used : 1) * 3 * sizeof(float));
+    f.world = malloc((size_t)(used > 0 ? used : 1) * 4 * sizeof(float));
+    f.setup = malloc((size_t)(ecount > 0 ? ecount : 1) * sizeof(edge_setup_t));
+    f.cursor = calloc((size_t)tiles, sizeof(atomic_int));
+    f.bin_start = malloc((size_t)(tiles + 1) * sizeof(int));
+    if (tiles == 0 || !f.screen || !f.world || !f.setup || !f.cursor || !f.bin_start) {
+        if (tiles > 0)
+            render_wireframe_lit(canvas, vertices, edges, vcount, ecount, model, view, proj,
+                                 lights, light_count, ambient);
+        goto done;
+    }
+
+    jobs_parallel_for(js, used, 0, transform_vertices, &f);
+    jobs_parallel_for(js, ecount, 0, setup_edges, &f);
+
+    // Counting sort of (tile, edge) pairs: prefix offsets, then parallel fill
+    f.bin_start[0] = 0;
+    for (int t = 0; t < tiles; ++t) {
+        f.bin_start[t + 1] = f.bin_start[t] + atomic_load_explicit(&f.cursor[t], memory_order_relaxed);
+        atomic_store_explicit(&f.cursor[t], f.bin_start[t], memory_order_relaxed);
+    }
+    f.bins = malloc((size_t)(f.bin_start[tiles] > 0 ? f.bin_start[tiles] : 1) * sizeof(int));
+    if (!f.bins) {
+        render_wireframe_lit(canvas, vertices, edges, vcount, ecount, model, view, proj,
+                             lights, light_count, ambient);
+        goto done;
+    }
+    jobs_parallel_for(js, ecount, 0, bin_edges, &f);
+    jobs_parallel_for(js, tiles, 1, raster_tiles, &f);
+
+done:
+    free(f.screen);
+    free(f.world);
+    free(f.setup);
+    free((void*)f.cursor);
+    free(f.bin_start);
+    free(f.bins);
+}
+
+void render_faces_lit(canvas_t* canvas, canvas_t* depth,
+                      const vec3_t* vertices, const int* faces, int face_stride, int face_count,
+                      const mat4_t* model, const mat4_t* view, const mat4_t* proj,
+                      const vec3_t* lights, int light_count,
+                      float ambient) {
+    for (int f = 0; f < face_count; ++f) {
+        const int* face = faces + (size_t)f * face_stride;
+        int n = 0;
+        while (n < face_stride && face[n] >= 0) n++;
+        if (n < 3) continue;
+
+        // Project the polygon; faces crossing the near/far planes are skipped,
+        // and so are faces too large to project, rather than drawing a prefix
+        if (n > RENDER_FACE_MAX) continue;
+        float sx[RENDER_FACE_MAX], sy[RENDER_FACE_MAX], sz[RENDER_FACE_MAX];
+        int clipped = 0;
+        for (int i = 0; i < n; ++i) {
+            project_vertex(canvas->width, canvas->height, vertices[face[i]], model, view, proj, &sx[i], &sy[i], &sz[i]);
+            if (!(sz[i] >= -1.0f && sz[i] <= 1.0f)) clipped = 1;
+        }
+        if (clipped) continue;
+
+        // Flat normal from the first three world-space vertices, turned to
+        // face the viewer so either winding lights correctly
+        float p0[4] = { vertices[face[0]].x, vertices[face[0]].y, vertices[face[0]].z, 1.0f };
+        float p1[4] = { vertices[face[1]].x, vertices[face[1]].y, vertices[face[1]].z, 1.0f };
+        float p2[4] = { vertices[face[2]].x, vertices[face[2]].y, vertices[face[2]].z, 1.0f };
+        float w0[4], w1[4], w2[4];
+        mat4_apply(model, p0, w0);
+        mat4_apply(model, p1, w1);
+        mat4_apply(model, p2, w2);
+        vec3_t normal = vec3_normalize_fast(vec3_cross(
+            vec3_init(w1[0] - w0[0], w1[1] - w0[1], w1[2] - w0[2]),
+            vec3_init(w2[0] - w0[0], w2[1] - w0[1], w2[2] - w0[2])));
+        // Screen y points down, so a positive area means the normal faces away
+        float area = (sx[1] - sx[0]) * (sy[2] - sy[0]) - (sy[1] - sy[0]) * (sx[2] - sx[0]);
+        if (area > 0.0f) normal = vec3_init(-normal.x, -normal.y, -normal.z);
+
+        float shade = lambert_multi(normal, lights, light_count);
+        float dz = 0.0f;
+        for (int i = 0; i < n; ++i) dz += sz[i];
+        dz /= n;
+        float attenuation = 1.0f / (1.0f + 0.5f * dz * dz);
+        float final = (ambient + (1.0f - ambient) * shade) * attenuation;
+
+        for (int i = 1; i + 1 < n; ++i)
+            fill_triangle_f(canvas, depth, sx[0], sy[0], sz[0], sx[i], sy[i], sz[i],
+                            sx[i + 1], sy[i + 1], sz[i + 1], final);
+    }
+}
+
+void render_wireframe_overlay(canvas_t* canvas, const canvas_t* depth,
+                              const vec3_t* vertices, const int edges[][2], int ecount,
+                              const mat4_t* model, const mat4_t* view, const mat4_t* proj,
+                              const vec3_t* lights, int light_count,
+                              float ambient, float bias) {
     for (int i = 0; i < ecount; ++i) {
         int a = edges[i][0], b = edges[i][1];
         float x0, y0, z0, x1, y1, z1;
-
-        project_vertex(canvas, vertices[a], model, view, proj, &x0, &y0, &z0);
-        project_vertex(canvas, vertices[b], model, view, proj, &x1, &y1, &z1);
+        project_vertex(canvas->width, canvas->height, vertices[a], model, view, proj, &x0, &y0, &z0);
+        project_vertex(canvas->width, canvas->height, vertices[b], model, view, proj, &x1, &y1, &z1);
+        if (!(z0 >= -1.0f && z0 <= 1.0f && z1 >= -1.0f && z1 <= 1.0f)) continue;
 
         float pa[4] = { vertices[a].x, vertices[a].y, vertices[a].z, 1.0f };
         float pb[4] = { vertices[b].x, vertices[b].y, vertices[b].z, 1.0f };
         float wa[4], wb[4];
+        mat4_apply(model, pa, wa);
+        mat4_apply(model, pb, wb);
+
+        float final = lit_intensity(wa, wb, z0, z1, lights, light_count, ambient);
+        draw_line_depth_f(canvas, depth, x0, y0, z0, x1, y1, z1, final, bias);
+    }
+}
+
+band_renderer_t* band_renderer_create(int width, int height, int band_height) {
+    if (width <= 0 || height <= 0 || band_height <= 0) return NULL;
+    band_renderer_t* br = calloc(1, sizeof(band_renderer_t));
+    if (!br) return NULL;
+    br->width = width;
+    br->height = height;
+    br->band_height = band_height < height ? band_height : height;
+    br->band = canvas_create(width, br->band_height);
+    if (!br->band) {
+        free(br);
+        return NULL;
+    }
+    return br;
+}
+
+void band_renderer_destroy(band_renderer_t* br) {
+    if (!br) return;
+    canvas_destroy(br->band);
+    free(br->edges);
+    free(br);
+}
+
+int band_renderer_add_line(band_renderer_t* br, float x0, float y0, float x1, float y1,
+                           float intensity) {
+    if (!isfinite(x0) || !isfinite(y0) || !isfinite(x1) || !isfinite(y1)) return 0;
+    // Samples truncate toward zero, so anything above -1 can still land on row/column 0
+    if (fmaxf(x0, x1) <= -1.0f || fminf(x0, x1) >= (float)br->width ||
+        fmaxf(y0, y1) <= -1.0f || fminf(y0, y1) >= (float)br->height)
+        return 0;
 
+    if (br->edge_count == br->edge_capacity) {
+        int capacity = br->edge_capacity ? br->edge_capacity * 2 : 256;
+        band_edge_t* edges = realloc(br->edges, (size_t)capacity * sizeof(band_edge_t));
+        if (!edges) return -1;
+        br->edges = edges;
+        br->edge_capacity = capacity;
+    }
+    br->edges[br->edge_count++] = (band_edge_t){ x0, y0, x1, y1, intensity };
+    return 0;
+}
+
+int band_renderer_add_lit(band_renderer_t* br,
+                          const vec3_t* vertices, const int edges[][2], int ecount,
+                          const mat4_t* model, const mat4_t* view, const mat4_t* proj,
+                          const vec3_t* lights, int light_count, float ambient) {
+    // Same projection and shading as draw_lit_edge, against the full image size
+    for (int i = 0; i < ecount; ++i) {
+        int a = edges[i][0], b = edges[i][1];
+        float x0, y0, z0, x1, y1, z1;
+        project_vertex(br->width, br->height, vertices[a], model, view, proj, &x0, &y0, &z0);
+        project_vertex(br->width, br->height, vertices[b], model, view, proj, &x1, &y1, &z1);
+
+        float pa[4] = { vertices[a].x, vertices[a].y, vertices[a].z, 1.0f };
+        float pb[4] = { vertices[b].x, vertices[b].y, vertices[b].z, 1.0f };
+        float wa[4], wb[4];
         mat4_apply(model, pa, wa);
         mat4_apply(model, pb, wb);
 
-        vec3_t dir = vec3_normalize_fast(vec3_init(wb[0] - wa[0], wb[1] - wa[1], wb[2] - wa[2]));
-        float shade = lambert_multi(dir, lights, light_count);
-        float dz = (z0 + z1) * 0.5f;                         // average projected depth
-        float attenuation = 1.0f / (1.0f + 0.5f * dz * dz);   // tweak strength as needed
-        float final = (ambient + (1.0f - ambient) * shade) * attenuation;
+        float final = lit_intensity(wa, wb, z0, z1, lights, light_count, ambient);
+        if (band_renderer_add_line(br, x0, y0, x1, y1, final) != 0) return -1;
+    }
+    return 0;
+}
+
+typedef struct {
+    int first, last;             // bands touched, inclusive
+    int edge;
+} band_span_t;
+
+static int compare_span_first(const void* a, const void* b) {
+    const band_span_t *sa = a, *sb = b;
+    return (sa->first > sb->first) - (sa->first < sb->first);
+}
 
-        draw_line_f(canvas, x0, y0, x1, y1, final);
+static band_span_t band_span(const band_renderer_t* br, int edge, int bands) {
+    const band_edge_t* e = &br->edges[edge];
+    float lo = fmaxf(fminf(e->y0, e->y1), 0.0f);
+    float hi = fminf(fmaxf(e->y0, e->y1), (float)(br->height - 1));
+    band_span_t s = { (int)lo / br->band_height, (int)hi / br->band_height, edge };
+    if (s.first > bands - 1) s.first = bands - 1;
+    if (s.last > bands - 1) s.last = bands - 1;
+    return s;
+}
+
+int band_renderer_write_pgm(band_renderer_t* br, const char* filename) {
+    int bands = (br->height - 1) / br->band_height + 1;
+    size_t n = br->edge_count > 0 ? (size_t)br->edge_count : 1;
+    band_span_t* spans = malloc(n * sizeof(band_span_t));
+    int* active = malloc(n * sizeof(int));
+    pgm_writer_t* w = NULL;
+    int status = -1;
+    if (!spans || !active) goto done;
+
+    // Sweep the bands top to bottom with an active-edge list: edges enter in
+    // order of their first band and leave after their last, so the extra
+    // memory is two arrays of edge_count, whatever the image height
+    for (int i = 0; i < br->edge_count; ++i) spans[i] = band_span(br, i, bands);
+    qsort(spans, (size_t)br->edge_count, sizeof(band_span_t), compare_span_first);
+
+    w = pgm_writer_open(filename, br->width, br->height);
+    if (!w) goto done;
+    int next = 0, active_count = 0;
+    for (int b = 0; b < bands; ++b) {
+        int y0 = b * br->band_height;
+        int rows = br->height - y0 < br->band_height ? br->height - y0 : br->band_height;
+        while (next < br->edge_count && spans[next].first == b) active[active_count++] = next++;
+
+        canvas_clear(br->band, 0.0f);
+        int kept = 0;
+        for (int k = 0; k < active_count; ++k) {
+            const band_span_t* s = &spans[active[k]];
+            const band_edge_t* e = &br->edges[s->edge];
+            draw_line_f_band(br->band, e->x0, e->y0, e->x1, e->y1, e->intensity, y0);
+            if (s->last > b) active[kept++] = active[k];
+        }
+        active_count = kept;
+        if (pgm_writer_rows(w, br->band, rows) != 0) goto done;
     }
+    status = 0;
+
+done:
+    if (w && pgm_writer_close(w) != 0) status = -1;
+    free(spans);
+    free(active);
+    return status;
 }
@@ -0,0 +1,214 @@
+#include "shmring.h"
+#include <stdatomic.h>
+#include <string.h>
+#include <stdlib.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#define RING_MAGIC 0x52443354u   // "T3DR"
+#define RING_VERSION 1u
+#define RING_ALIGN 64
+#define READ_RETRIES 64
+
+typedef struct {
+    uint32_t magic, version;
+    uint32_t slot_count, width, height, reserved;
+    uint64_t slot_stride;
+    _Atomic uint64_t latest;     // newest published frame number, 0 = none
+} ring_header_t;
+
+typedef struct {
+    _Atomic uint32_t seq;        // odd while the slot is being written
+    uint32_t reserved;
+    _Atomic uint64_t frame;      // frame number held by the slot
+} slot_header_t;
+
+static size_t align_up(size_t v) {
+    return (v + RING_ALIGN - 1) & ~(size_t)(RING_ALIGN - 1);
+}
+
+static ring_header_t* ring_header(const shm_ring_t* r) {
+    return (ring_header_t*)r->base;
+}
+
+static slot_header_t* ring_slot(const shm_ring_t* r, uint64_t frame) {
+    size_t index = (size_t)((frame - 1) % (uint64_t)r->slot_count);
+    return (slot_header_t*)(r->base + align_up(sizeof(ring_header_t)) + index * r->slot_stride);
+}
+
+static float* slot_pixels(slot_header_t* s) {
+    return (float*)((unsigned char*)s + align_up(sizeof(slot_header_t)));
+}
+
+// An existing object is provably stale only if its header was completed
+// (the publisher locks before writing it) and no process holds the
+// publisher lock any more. Removes it and returns 1 in that case.
+static int unlink_if_stale(const char* name) {
+    int fd = shm_open(name, O_RDONLY, 0);
+    if (fd < 0) return errno == ENOENT;
+    int stale = 0;
+    struct stat st;
+    if (flock(fd, LOCK_EX | LOCK_NB) == 0 && fstat(fd, &st) == 0) {
+        if (st.st_nlink == 0) {
+            // Another process already removed it while we waited
+            stale = 1;
+        } else if ((size_t)st.st_size >= sizeof(ring_header_t)) {
+            ring_header_t* h = mmap(NULL, sizeof(ring_header_t), PROT_READ, MAP_SHARED, fd, 0);
+            if (h != MAP_FAILED) {
+                stale = h->magic == RING_MAGIC;
+                munmap(h, sizeof(ring_header_t));
+            }
+            // Unlink while still holding the lock so a concurrent checker
+            // sees nlink == 0 instead of removing our replacement
+            if (stale) shm_unlink(name);
+        }
+    }
+    close(fd);
+    return stale;
+}
+
+shm_ring_t* shm_ring_create(const char* name, int slot_count, int width, int height, int flags) {
+    if (slot_count < 2 || width <= 0 || height <= 0 || strlen(name) >= 64) return NULL;
+    shm_ring_t* r = calloc(1, sizeof(shm_ring_t));
+    if (!r) return NULL;
+    strcpy(r->name, name);
+    r->slot_count = slot_count;
+    r->width = width;
+    r->height = height;
+    r->slot_stride = align_up(align_up(sizeof(slot_header_t)) + (size_t)width * height * sizeof(float));
+    r->size = align_up(sizeof(ring_header_t)) + r->slot_stride * (size_t)slot_count;
+
+    if (flags & SHM_RING_REPLACE) shm_unlink(name);
+    r->fd = shm_open(name, O_CREAT | O_EXCL | O_RDWR, 0644);
+    if (r->fd < 0 && errno == EEXIST && unlink_if_stale(name))
+        r->fd = shm_open(name, O_CREAT | O_EXCL | O_RDWR, 0644);
+    if (r->fd < 0) {
+        free(r);
+        return NULL;
+    }
+    r->owner = 1;
+    // Held until the fd is closed, including by a crash
+    if (flock(r->fd, LOCK_EX | LOCK_NB) != 0 || ftruncate(r->fd, (off_t)r->size) != 0 ||
+        (r->base = mmap(NULL, r->size, PROT_READ | PROT_WRITE, MAP_SHARED, r->fd, 0)) == MAP_FAILED) {
+        r->base = NULL;
+        shm_ring_destroy(r);
+        return NULL;
+    }
+
+    // ftruncate zero-fills, so every slot starts at seq 0 / frame 0
+    ring_header_t* h = ring_header(r);
+    h->slot_count = (uint32_t)slot_count;
+    h->width = (uint32_t)width;
+    h->height = (uint32_t)height;
+    h->slot_stride = r->slot_stride;
+    h->version = RING_VERSION;
+    atomic_store_explicit(&h->latest, 0, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+    h->magic = RING_MAGIC;
+    return r;
+}
+
+canvas_t* shm_ring_begin_frame(shm_ring_t* r) {
+    slot_header_t* s = ring_slot(r, ++r->frame);
+    uint32_t seq = atomic_load_explicit(&s->seq, memory_order_relaxed);
+    atomic_store_explicit(&s->seq, seq + 1, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+    atomic_store_explicit(&s->frame, r->frame, memory_order_relaxed);
+
+    r->canvas.width = r->width;
+    r->canvas.height = r->height;
+    r->canvas.data = slot_pixels(s);
+    return &r->canvas;
+}
+
+void shm_ring_publish(shm_ring_t* r) {
+    slot_header_t* s = ring_slot(r, r->frame);
+    uint32_t seq = atomic_load_explicit(&s->seq, memory_order_relaxed);
+    atomic_store_explicit(&s->seq, seq + 1, memory_order_release);
+    atomic_store_explicit(&ring_header(r)->latest, r->frame, memory_order_release);
+}
+
+shm_ring_t* shm_ring_open(const char* name) {
+    if (strlen(name) >= 64) return NULL;
+    shm_ring_t* r = calloc(1, sizeof(shm_ring_t));
+    if (!r) return NULL;
+    strcpy(r->name, name);
+    r->fd = shm_open(name, O_RDONLY, 0);
+    struct stat st;
+    if (r->fd < 0 || fstat(r->fd, &st) != 0 || (size_t)st.st_size < sizeof(ring_header_t)) {
+        shm_ring_destroy(r);
+        return NULL;
+    }
+    r->size = (size_t)st.st_size;
+    r->base = mmap(NULL, r->size, PROT_READ, MAP_SHARED, r->fd, 0);
+    if (r->base == MAP_FAILED) {
+        r->base = NULL;
+        shm_ring_destroy(r);
+        return NULL;
+    }
+
+    const ring_header_t* h = ring_header(r);
+    if (h->magic != RING_MAGIC || h->version != RING_VERSION || h->slot_count < 2 ||
+        align_up(sizeof(ring_header_t)) + h->slot_stride * h->slot_count > r->size ||
+        align_up(sizeof(slot_header_t)) + (size_t)h->width * h->height * sizeof(float) > h->slot_stride) {
+        shm_ring_destroy(r);
+        return NULL;
+    }
+    atomic_thread_fence(memory_order_acquire);
+    r->slot_count = (int)h->slot_count;
+    r->width = (int)h->width;
+    r->height = (int)h->height;
+    r->slot_stride = (size_t)h->slot_stride;
+    return r;
+}
+
+uint64_t shm_ring_latest(const shm_ring_t* r) {
+    return atomic_load_explicit(&ring_header(r)->latest, memory_order_acquire);
+}
+
+const float* shm_ring_read_begin(shm_ring_t* r, uint64_t* frame, uint32_t* token) {
+    for (int attempt = 0; attempt < READ_RETRIES; ++attempt) {
+        uint64_t n = shm_ring_latest(r);
+        if (n == 0) return NULL;
+        slot_header_t* s = ring_slot(r, n);
+        uint32_t seq = atomic_load_explicit(&s->seq, memory_order_acquire);
+        // Odd: the publisher has lapped the ring and is rewriting this slot
+        if ((seq & 1) || atomic_load_explicit(&s->frame, memory_order_relaxed) != n) continue;
+        *frame = n;
+        *token = seq;
+        return slot_pixels(s);
+    }
+    return NULL;
+}
+
+int shm_ring_read_end(shm_ring_t* r, uint64_t frame, uint32_t token) {
+    slot_header_t* s = ring_slot(r, frame);
+    atomic_thread_fence(memory_order_acquire);
+    return atomic_load_explicit(&s->seq, memory_order_relaxed) == token &&
+           atomic_load_explicit(&s->frame, memory_order_relaxed) == frame;
+}
+
+uint64_t shm_ring_read_latest(shm_ring_t* r, canvas_t* out) {
+    if (out->width != r->width || out->height != r->height) return 0;
+    for (int attempt = 0; attempt < READ_RETRIES; ++attempt) {
+        uint64_t frame;
+        uint32_t token;
+        const float* pixels = shm_ring_read_begin(r, &frame, &token);
+        if (!pixels) return 0;
+        memcpy(out->data, pixels, (size_t)r->width * r->height * sizeof(float));
+        if (shm_ring_read_end(r, frame, token)) return frame;
+    }
+    return 0;
+}
+
+void shm_ring_destroy(shm_ring_t* r) {
+    if (!r) return;
+    if (r->base) munmap(r->base, r->size);
+    if (r->fd >= 0) close(r->fd);
+    if (r->owner) shm_unlink(r->name);
+    free(r);
+}
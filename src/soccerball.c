@@ -90,3 +90,9 @@ void generate_soccerball(vec3_t vertices[SOCCERBALL_VERTEX_COUNT],
     }
 }
 
+
+void generate_soccerball_faces(int out[SOCCERBALL_FACE_COUNT][SOCCERBALL_FACE_MAX]) {
+    for (int f = 0; f < SOCCERBALL_FACE_COUNT; ++f)
+        for (int i = 0; i < SOCCERBALL_FACE_MAX; ++i)
+            out[f][i] = faces[f][i];
+}
@@ -0,0 +1,121 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stddef.h>
+#include <math.h>
+#include "canvas.h"
+#include "bvh.h"
+#include "renderer.h"
+
+#define WIDTH  331
+#define HEIGHT 247
+#define VERTS  4001
+#define EDGES  (VERTS - 1)
+
+static float frand(float lo, float hi) {
+    return lo + (hi - lo) * (rand() / (float)RAND_MAX);
+}
+
+// Renders the scene both ways and compares every pixel
+static int same_render(const bvh_t* bvh, const vec3_t* verts, const int edges[][2],
+                       vec3_t offset) {
+    mat4_t proj, view, model;
+    mat4_perspective(&proj, M_PI / 3.0f, (float)WIDTH / HEIGHT, 0.1f, 100.0f);
+    mat4_lookat(&view, vec3_init(0, 0, 6), vec3_init(0, 0, 0), vec3_init(0, 1, 0));
+    mat4_translate(&model, offset);
+    vec3_t lights[1] = { vec3_normalize(vec3_init(1, 1, 1)) };
+
+    canvas_t* a = canvas_create(WIDTH, HEIGHT);
+    canvas_t* b = canvas_create(WIDTH, HEIGHT);
+    render_wireframe_lit(a, verts, edges, VERTS, EDGES, &model, &view, &proj, lights, 1, 0.2f);
+    render_wireframe_lit_bvh(b, bvh, verts, edges, EDGES, &model, &view, &proj,
+                             lights, 1, 0.2f, 0.0f);
+    int lit = 0;
+    for (int i = 0; i < WIDTH * HEIGHT; ++i) lit += a->data[i] > 0.0f;
+    int ok = lit > 0 && memcmp(a->data, b->data, sizeof(float) * WIDTH * HEIGHT) == 0;
+    canvas_destroy(a);
+    canvas_destroy(b);
+    return ok;
+}
+
+// Saves bvh with one field patched at byte offset `at`; returns whether it loads
+static int loads_patched(const bvh_t* bvh, long at, int value) {
+    const char* path = "test_bvh_patched.bvh";
+    bvh_save(bvh, path);
+    FILE* f = fopen(path, "r+b");
+    fseek(f, at, SEEK_SET);
+    fwrite(&value, sizeof(int), 1, f);
+    fclose(f);
+    bvh_t* loaded = bvh_load(path);
+    remove(path);
+    bvh_destroy(loaded);
+    return loaded != NULL;
+}
+
+int main() {
+    // Random walk: short edges clustered in space give the tree real depth
+    vec3_t* verts = malloc(VERTS * sizeof(vec3_t));
+    int (*edges)[2] = malloc(EDGES * sizeof(*edges));
+    srand(17);
+    verts[0] = vec3_init(0, 0, 0);
+    for (int i = 1; i < VERTS; ++i) {
+        vec3_t p = verts[i - 1];
+        verts[i] = vec3_init(fminf(fmaxf(p.x + frand(-0.2f, 0.2f), -3.0f), 3.0f),
+                             fminf(fmaxf(p.y + frand(-0.2f, 0.2f), -3.0f), 3.0f),
+                             fminf(fmaxf(p.z + frand(-0.2f, 0.2f), -3.0f), 3.0f));
+    }
+    for (int i = 0; i < EDGES; ++i) {
+        edges[i][0] = i;
+        edges[i][1] = i + 1;
+    }
+
+    printf("=== Edge BVH ===\n");
+    int failures = 0;
+    bvh_t* bvh = bvh_build(verts, (const int (*)[2])edges, EDGES);
+
+    // Camera outside the scene: centred, then panned so parts fall off each side
+    const vec3_t offsets[] = {
+        { 0.0f, 0.0f, -2.0f, 0, 0, 0 }, { 3.5f, 0.0f, -2.0f, 0, 0, 0 },
+        { -3.5f, 2.5f, -2.0f, 0, 0, 0 }, { 1.0f, -3.0f, -2.0f, 0, 0, 0 },
+    };
+    for (size_t i = 0; i < sizeof(offsets) / sizeof(offsets[0]); ++i) {
+        if (!same_render(bvh, verts, (const int (*)[2])edges, offsets[i])) {
+            printf("❌ BVH render differs from the linear path (view %zu)\n", i);
+            ++failures;
+        }
+    }
+
+    // Round trip
+    bvh_t* loaded = NULL;
+    if (bvh_save(bvh, "test_bvh.bvh") != 0 || !(loaded = bvh_load("test_bvh.bvh")) ||
+        loaded->node_count != bvh->node_count || loaded->edge_count != bvh->edge_count ||
+        memcmp(loaded->nodes, bvh->nodes, sizeof(bvh_node_t) * bvh->node_count) != 0 ||
+        memcmp(loaded->edge_index, bvh->edge_index, sizeof(int) * bvh->edge_count) != 0 ||
+        !same_render(loaded, verts, (const int (*)[2])edges, offsets[1])) {
+        printf("❌ save/load round trip\n");
+        ++failures;
+    }
+    bvh_destroy(loaded);
+    remove("test_bvh.bvh");
+
+    // Corrupt files: out-of-range edge id, child index and leaf range
+    long nodes_at = 4 * sizeof(unsigned int);
+    long edges_at = nodes_at + (long)sizeof(bvh_node_t) * bvh->node_count;
+    long root_left = nodes_at + (long)offsetof(bvh_node_t, left);
+    long root_count = nodes_at + (long)offsetof(bvh_node_t, count);
+    if (loads_patched(bvh, edges_at + 5 * sizeof(int), EDGES) ||
+        loads_patched(bvh, root_left, bvh->node_count) ||
+        loads_patched(bvh, root_left, 0) ||
+        loads_patched(bvh, root_count, EDGES + 1) ||
+        loads_patched(bvh, 3 * sizeof(unsigned int), EDGES + 1)) {
+        printf("❌ corrupt file accepted\n");
+        ++failures;
+    }
+
+    bvh_destroy(bvh);
+    free(verts);
+    free(edges);
+    if (failures) return 1;
+    printf("✅ BVH render matches the linear path; save/load validated\n");
+    return 0;
+}
@@ -0,0 +1,127 @@
+#include <stdio.h>
+#include <math.h>
+#include <unistd.h>
+#include "canvas.h"
+#include "delta.h"
+
+#define WIDTH  200
+#define HEIGHT 150
+#define FRAMES 40
+
+// Draws a rotating spoke pattern so consecutive frames differ in a few tiles
+static void draw_frame(canvas_t* c, int frame) {
+    canvas_clear(c, 0.0f);
+    float a = frame * 0.1f;
+    for (int k = 0; k < 3; ++k) {
+        float ang = a + k * 2.094f;
+        draw_line_f(c, WIDTH / 2.0f, HEIGHT / 2.0f,
+                    WIDTH / 2.0f + cosf(ang) * 60.0f, HEIGHT / 2.0f + sinf(ang) * 60.0f,
+                    0.3f + 0.2f * k);
+    }
+    if (frame % 10 == 0) canvas_clear(c, 0.5f);   // full-frame change
+}
+
+static int compare(const canvas_t* a, const canvas_t* b) {
+    for (int i = 0; i < WIDTH * HEIGHT; ++i) {
+        int pa = (int)(255.0f * fminf(fmaxf(a->data[i], 0.0f), 1.0f));
+        int pb = (int)(255.0f * fminf(fmaxf(b->data[i], 0.0f), 1.0f));
+        if (pa != pb) return 0;
+    }
+    return 1;
+}
+
+int main() {
+    const char* path = "test_delta.t3ds";
+    canvas_t* c = canvas_create(WIDTH, HEIGHT);
+    canvas_t* out = canvas_create(WIDTH, HEIGHT);
+
+    delta_writer_t* w = delta_writer_open(path, WIDTH, HEIGHT, 16);
+    for (int f = 0; f < FRAMES; ++f) {
+        draw_frame(c, f);
+        delta_writer_add(w, c);
+    }
+    delta_writer_close(w);
+
+    delta_reader_t* r = delta_reader_open(path);
+    if (!r || r->frame_count != FRAMES) {
+        printf("❌ could not reopen sequence\n");
+        return 1;
+    }
+
+    // Sequential playback, then random access in both directions
+    int order[FRAMES + 4] = { 0 };
+    for (int f = 0; f < FRAMES; ++f) order[f] = f;
+    order[FRAMES] = 37; order[FRAMES + 1] = 5; order[FRAMES + 2] = 17; order[FRAMES + 3] = 16;
+
+    int failures = 0;
+    for (int i = 0; i < FRAMES + 4; ++i) {
+        int f = order[i];
+        draw_frame(c, f);
+        if (delta_reader_frame(r, f, out) != 0 || !compare(c, out)) {
+            printf("❌ frame %d mismatch\n", f);
+            ++failures;
+        }
+    }
+
+    FILE* fp = fopen(path, "rb");
+    fseek(fp, 0, SEEK_END);
+    long size = ftell(fp);
+    fclose(fp);
+
+    // A sequence cut off mid-record keeps only its complete frames
+    if (truncate(path, size - 3) != 0) {
+        printf("❌ could not truncate sequence\n");
+        ++failures;
+    }
+    delta_reader_t* cut = delta_reader_open(path);
+    if (!cut || cut->frame_count != FRAMES - 1 ||
+        delta_reader_frame(cut, FRAMES - 2, out) != 0 || delta_reader_frame(cut, FRAMES - 1, out) == 0) {
+        printf("❌ truncated sequence not indexed up to the last complete frame\n");
+        ++failures;
+    }
+    delta_reader_close(cut);
+
+    // A delta record too short for its tile mask ends the sequence too
+    const unsigned char short_delta[] = { 'D', 1, 0, 0, 0, 0xff };
+    if (truncate(path, r->offsets[FRAMES - 1]) != 0 || !(fp = fopen(path, "ab")) ||
+        fwrite(short_delta, sizeof(short_delta), 1, fp) != 1 || fclose(fp) != 0) {
+        printf("❌ could not append a short delta record\n");
+        ++failures;
+    }
+    cut = delta_reader_open(path);
+    if (!cut || cut->frame_count != FRAMES - 1) {
+        printf("❌ delta record shorter than its tile mask was indexed\n");
+        ++failures;
+    }
+    delta_reader_close(cut);
+
+    // Nonsense dimensions are refused before anything is allocated
+    const unsigned char bad_dims[][8] = {
+        { 0, 0, 0, 0, 150, 0, 0, 0 },
+        { 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff },
+        { 0xff, 0xff, 0xff, 0x7f, 0xff, 0xff, 0xff, 0x7f },
+    };
+    for (size_t i = 0; i < sizeof(bad_dims) / sizeof(bad_dims[0]); ++i) {
+        fp = fopen(path, "r+b");
+        fseek(fp, 8, SEEK_SET);
+        fwrite(bad_dims[i], sizeof(bad_dims[i]), 1, fp);
+        fclose(fp);
+        delta_reader_t* bad = delta_reader_open(path);
+        if (bad) {
+            printf("❌ header with bad dimensions accepted (case %zu)\n", i);
+            ++failures;
+            delta_reader_close(bad);
+        }
+    }
+    remove(path);
+
+    printf("=== Delta Sequence ===\n");
+    printf("%d frames, %ld bytes (raw 8-bit: %d bytes)\n", FRAMES, size, FRAMES * WIDTH * HEIGHT);
+
+    delta_reader_close(r);
+    canvas_destroy(c);
+    canvas_destroy(out);
+    if (failures) return 1;
+    printf("✅ All frames reconstructed\n");
+    return 0;
+}
@@ -0,0 +1,135 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include "canvas.h"
+#include "fixed.h"
+#include "renderer.h"
+#include "soccerball.h"
+
+#define WIDTH  512
+#define HEIGHT 512
+
+// Tolerances: a pixel "differs" when its 8-bit value is off by more than
+// PIXEL_TOLERANCE; at most MAX_DIFF_RATIO of the lit pixels may differ
+// (sub-pixel rounding moves a few samples onto the neighbouring pixel).
+#define PIXEL_TOLERANCE 4
+#define MAX_DIFF_RATIO  0.02
+
+// Within 0.1% of the exact reciprocal, or one Q16.16 step for large inputs
+static int check_recip(void) {
+    int bad = 0;
+    for (float v = 0.01f; v < 1000.0f; v *= 1.07f) {
+        fx_t x = fx_from_float(v);
+        double exact = (double)FX_ONE / x;
+        double r = fx_to_float(fx_recip(x));
+        if (fabs(r - exact) > fmax(exact * 1e-3, 1.0 / FX_ONE)) ++bad;
+    }
+    return bad == 0;
+}
+
+// Edges from the centre to points ever closer to the eye (w -> 0) run far
+// off the right edge; they must neither wrap into the left half nor vanish
+static int check_near_plane(const mat4_fx_t* view, const mat4_fx_t* proj) {
+    const int edges[1][2] = { { 0, 1 } };
+    vec3_fx_t light = vec3_to_fx(vec3_init(0, 0, 1));
+    mat4_t identity;
+    mat4_identity(&identity);
+    mat4_fx_t model;
+    mat4_to_fx(&model, &identity);
+    // Flatten depth so the attenuation doesn't fade the line out
+    mat4_fx_t flat = *proj;
+    flat.m[2] = flat.m[6] = flat.m[10] = flat.m[14] = 0;
+
+    canvas8_t* c = canvas8_create(WIDTH, HEIGHT);
+    int ok = 1;
+    for (float gap = 1.0f; gap > 1e-5f; gap *= 0.5f) {
+        vec3_fx_t verts[2] = { vec3_to_fx(vec3_init(0, 0, 0)), vec3_to_fx(vec3_init(1.0f, 0.3f, 6.0f - gap)) };
+        canvas8_clear(c, 0);
+        render_wireframe_lit_fx(c, verts, edges, 2, 1, &model, view, &flat, &light, 1, FX_ONE);
+        int left = 0, right = 0;
+        for (int y = 0; y < HEIGHT; ++y)
+            for (int x = 0; x < WIDTH; ++x)
+                if (c->data[(size_t)y * WIDTH + x]) {
+                    if (x < WIDTH / 2 - 1) ++left;
+                    else ++right;
+                }
+        if (left != 0 || right < WIDTH / 2 - 2) ok = 0;
+    }
+    canvas8_destroy(c);
+    return ok;
+}
+
+int main() {
+    if (!check_recip()) {
+        printf("❌ reciprocal table out of tolerance\n");
+        return 1;
+    }
+
+    vec3_t verts[SOCCERBALL_VERTEX_COUNT];
+    vec3_fx_t verts_fx[SOCCERBALL_VERTEX_COUNT];
+    int edges[SOCCERBALL_EDGE_MAX][2];
+    int edge_count = 0;
+    generate_soccerball(verts, edges, &edge_count);
+    for (int i = 0; i < SOCCERBALL_VERTEX_COUNT; ++i) verts_fx[i] = vec3_to_fx(verts[i]);
+
+    mat4_t proj, view;
+    mat4_perspective(&proj, M_PI / 3.0f, (float)WIDTH / HEIGHT, 0.1f, 100.0f);
+    mat4_lookat(&view, vec3_init(0, 0, 6), vec3_init(0, 0, 0), vec3_init(0, 1, 0));
+    mat4_fx_t proj_fx, view_fx;
+    mat4_to_fx(&proj_fx, &proj);
+    mat4_to_fx(&view_fx, &view);
+
+    if (!check_near_plane(&view_fx, &proj_fx)) {
+        printf("❌ edge ending near w = 0 wrapped or vanished\n");
+        return 1;
+    }
+
+    canvas_t* ref = canvas_create(WIDTH, HEIGHT);
+    canvas8_t* fx = canvas8_create(WIDTH, HEIGHT);
+    int failures = 0;
+
+    printf("=== Fixed vs Float Pipeline ===\n");
+    for (int frame = 0; frame < 8; ++frame) {
+        float t = frame / 8.0f;
+        vec3_t lights[1] = { vec3_normalize(vec3_init(cosf(6.28f * t), 1.0f, sinf(6.28f * t))) };
+        vec3_fx_t lights_fx[1] = { vec3_to_fx(lights[0]) };
+        // The last frame has no lights: both paths must agree rather than crash
+        int light_count = frame == 7 ? 0 : 1;
+
+        quat_t q = quat_from_axis_angle(vec3_init(0, 1, 0), 6.28f * t);
+        mat4_t rot, trans, model;
+        quat_to_mat4(&rot, q);
+        mat4_translate(&trans, vec3_init(-1.5f + 3.0f * t, 0.5f - t, -5.0f + 2.0f * t));
+        mat4_multiply(&model, &trans, &rot);
+        mat4_fx_t model_fx;
+        mat4_to_fx(&model_fx, &model);
+
+        canvas_clear(ref, 0.0f);
+        canvas8_clear(fx, 0);
+        render_wireframe_lit(ref, verts, (const int (*)[2])edges, SOCCERBALL_VERTEX_COUNT, edge_count,
+                             &model, &view, &proj, lights, light_count, 0.2f);
+        render_wireframe_lit_fx(fx, verts_fx, (const int (*)[2])edges, SOCCERBALL_VERTEX_COUNT, edge_count,
+                                &model_fx, &view_fx, &proj_fx, lights_fx, light_count,
+                                fx_from_float(0.2f));
+
+        int lit = 0, diff = 0;
+        for (int i = 0; i < WIDTH * HEIGHT; ++i) {
+            int a = (int)(255.0f * fminf(fmaxf(ref->data[i], 0.0f), 1.0f));
+            int b = fx->data[i];
+            if (a || b) ++lit;
+            if (abs(a - b) > PIXEL_TOLERANCE) ++diff;
+        }
+        double ratio = lit ? (double)diff / lit : 0.0;
+        printf("Frame %d: %d lit, %d differ (%.2f%%)\n", frame, lit, diff, 100.0 * ratio);
+        if (lit == 0 || ratio > MAX_DIFF_RATIO) ++failures;
+    }
+
+    canvas_destroy(ref);
+    canvas8_destroy(fx);
+    if (failures) {
+        printf("❌ %d frame(s) outside tolerance\n", failures);
+        return 1;
+    }
+    printf("✅ Fixed-point output within tolerance\n");
+    return 0;
+}
@@ -0,0 +1,144 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include <math.h>
+#include "canvas.h"
+#include "jobs.h"
+#include "renderer.h"
+#include "soccerball.h"
+
+#define WIDTH  517
+#define HEIGHT 389
+#define RANDOM_VERTS 2000
+#define RANDOM_EDGES 20000
+
+typedef struct {
+    job_system_t* js;
+    atomic_long sum;
+    int* hits;
+} sum_ctx_t;
+
+// Threads inside count_items right now, and the most seen at once
+static atomic_int active, peak;
+
+static void count_items(void* ctx, int begin, int end) {
+    sum_ctx_t* s = ctx;
+    int now = atomic_fetch_add(&active, 1) + 1;
+    int seen = atomic_load(&peak);
+    while (now > seen && !atomic_compare_exchange_weak(&peak, &seen, now)) {}
+    for (int i = begin; i < end; ++i) {
+        s->hits[i]++;
+        atomic_fetch_add(&s->sum, i);
+    }
+    atomic_fetch_sub(&active, 1);
+}
+
+// Each outer item runs an inner parallel loop (nested submission from workers)
+static void nested_items(void* ctx, int begin, int end) {
+    sum_ctx_t* s = ctx;
+    for (int i = begin; i < end; ++i) {
+        sum_ctx_t inner = { s->js, 0, calloc(1000, sizeof(int)) };
+        jobs_parallel_for(s->js, 1000, 10, count_items, &inner);
+        atomic_fetch_add(&s->sum, atomic_load(&inner.sum));
+        free(inner.hits);
+    }
+}
+
+static int check_parallel_for(job_system_t* js) {
+    const int n = 1000000;
+    sum_ctx_t s = { js, 0, calloc(n, sizeof(int)) };
+    jobs_parallel_for(js, n, 0, count_items, &s);
+    int ok = atomic_load(&s.sum) == (long)n * (n - 1) / 2;
+    for (int i = 0; i < n && ok; ++i) ok = s.hits[i] == 1;
+    free(s.hits);
+
+    sum_ctx_t nested = { js, 0, NULL };
+    jobs_parallel_for(js, 64, 1, nested_items, &nested);
+    return ok && atomic_load(&nested.sum) == 64L * 999 * 1000 / 2;
+}
+
+static void* external_caller(void* arg) {
+    return (void*)(long)check_parallel_for(arg);
+}
+
+static int check_render(job_system_t* js) {
+    vec3_t* verts = malloc(RANDOM_VERTS * sizeof(vec3_t));
+    int (*edges)[2] = malloc(RANDOM_EDGES * sizeof(*edges));
+    srand(7);
+    for (int i = 0; i < RANDOM_VERTS; ++i)
+        verts[i] = vec3_init(rand() / (float)RAND_MAX * 6 - 3, rand() / (float)RAND_MAX * 6 - 3,
+                             rand() / (float)RAND_MAX * 4 - 2);
+    for (int i = 0; i < RANDOM_EDGES; ++i) {
+        edges[i][0] = rand() % RANDOM_VERTS;
+        edges[i][1] = rand() % RANDOM_VERTS;
+    }
+
+    mat4_t proj, view, model;
+    mat4_perspective(&proj, M_PI / 3.0f, (float)WIDTH / HEIGHT, 0.1f, 100.0f);
+    mat4_lookat(&view, vec3_init(0, 0, 6), vec3_init(0, 0, 0), vec3_init(0, 1, 0));
+    mat4_translate(&model, vec3_init(0.3f, -0.2f, -1.0f));
+    vec3_t lights[2] = { vec3_normalize(vec3_init(1, 1, 0)), vec3_normalize(vec3_init(-1, 0, 1)) };
+
+    canvas_t* a = canvas_create(WIDTH, HEIGHT);
+    canvas_t* b = canvas_create(WIDTH, HEIGHT);
+    render_wireframe_lit(a, verts, (const int (*)[2])edges, RANDOM_VERTS, RANDOM_EDGES,
+                         &model, &view, &proj, lights, 2, 0.2f);
+    render_wireframe_lit_mt(js, b, verts, (const int (*)[2])edges, RANDOM_VERTS, RANDOM_EDGES,
+                            &model, &view, &proj, lights, 2, 0.2f);
+    int ok = memcmp(a->data, b->data, sizeof(float) * WIDTH * HEIGHT) == 0;
+
+    // Frame encoding stage
+    canvas_to_pgm(a, "test_jobs_st.pgm");
+    canvas_to_pgm_mt(js, a, "test_jobs_mt.pgm");
+    FILE* fa = fopen("test_jobs_st.pgm", "rb");
+    FILE* fb = fopen("test_jobs_mt.pgm", "rb");
+    int ca, cb;
+    do {
+        ca = fgetc(fa);
+        cb = fgetc(fb);
+    } while (ca == cb && ca != EOF);
+    ok = ok && ca == cb;
+    fclose(fa);
+    fclose(fb);
+    remove("test_jobs_st.pgm");
+    remove("test_jobs_mt.pgm");
+
+    canvas_destroy(a);
+    canvas_destroy(b);
+    free(verts);
+    free(edges);
+    return ok;
+}
+
+int main() {
+    job_system_t* js = jobs_create(4);   // fixed count so stealing is exercised on any machine
+    printf("=== Job System (%d threads) ===\n", jobs_thread_count(js));
+
+    int failures = 0;
+    if (!check_parallel_for(js)) { printf("❌ parallel_for\n"); ++failures; }
+    if (!check_parallel_for(NULL)) { printf("❌ serial fallback\n"); ++failures; }
+
+    // Several outside threads submitting to the same pool at once; they
+    // must share the pool's threads rather than add to them
+    atomic_store(&peak, 0);
+    pthread_t callers[4];
+    for (int i = 0; i < 4; ++i) pthread_create(&callers[i], NULL, external_caller, js);
+    for (int i = 0; i < 4; ++i) {
+        void* ok;
+        pthread_join(callers[i], &ok);
+        if (!ok) { printf("❌ concurrent caller %d\n", i); ++failures; }
+    }
+    if (atomic_load(&peak) > jobs_thread_count(js)) {
+        printf("❌ %d jobs ran at once on a %d-thread pool\n", atomic_load(&peak), jobs_thread_count(js));
+        ++failures;
+    }
+
+    if (!check_render(js)) { printf("❌ multi-threaded render differs\n"); ++failures; }
+
+    jobs_destroy(js);
+    if (failures) return 1;
+    printf("✅ Parallel loops, rendering and PGM output match the serial path\n");
+    return 0;
+}
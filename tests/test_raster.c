@@ -0,0 +1,148 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include "canvas.h"
+#include "raster.h"
+#include "renderer.h"
+
+#define WIDTH  203
+#define HEIGHT 157
+#define TRIALS 300
+
+static float frand(float lo, float hi) {
+    return lo + (hi - lo) * (rand() / (float)RAND_MAX);
+}
+
+// Signed edge value at a pixel centre, in double precision
+static double edge(double ax, double ay, double bx, double by, double px, double py) {
+    return (bx - ax) * (py - ay) - (by - ay) * (px - ax);
+}
+
+// Pixels well inside must be filled and pixels well outside must not be;
+// those within eps of an edge are left to the fill rule
+static int check_coverage(const canvas_t* c, const float* v) {
+    double area = edge(v[0], v[1], v[2], v[3], v[4], v[5]);
+    double s = area > 0 ? 1.0 : -1.0;
+    for (int y = 0; y < HEIGHT; ++y) {
+        for (int x = 0; x < WIDTH; ++x) {
+            double px = x + 0.5, py = y + 0.5;
+            double e0 = s * edge(v[2], v[3], v[4], v[5], px, py);
+            double e1 = s * edge(v[4], v[5], v[0], v[1], px, py);
+            double e2 = s * edge(v[0], v[1], v[2], v[3], px, py);
+            double eps = 1e-3 * fabs(area) + 1e-3;
+            int filled = c->data[y * WIDTH + x] > 0.0f;
+            if (e0 > eps && e1 > eps && e2 > eps && !filled) return 0;
+            if ((e0 < -eps || e1 < -eps || e2 < -eps) && filled) return 0;
+        }
+    }
+    return 1;
+}
+
+int main() {
+    canvas_t* a = canvas_create(WIDTH, HEIGHT);
+    canvas_t* b = canvas_create(WIDTH, HEIGHT);
+    canvas_t* depth = canvas_create(WIDTH, HEIGHT);
+    int failures = 0;
+    srand(11);
+
+    printf("=== Triangle Rasterizer ===\n");
+    for (int t = 0; t < TRIALS; ++t) {
+        // Two triangles, partly off-canvas, on either side of a shared edge
+        float q[8];
+        do {
+            for (int i = 0; i < 4; ++i) {
+                q[i * 2] = frand(-30.0f, WIDTH + 30.0f);
+                q[i * 2 + 1] = frand(-30.0f, HEIGHT + 30.0f);
+            }
+            if (t % 3 == 0) { q[5] = q[1] = floorf(q[1]) + 0.5f; }   // horizontal edge through pixel centres
+        } while (edge(q[0], q[1], q[4], q[5], q[2], q[3]) * edge(q[0], q[1], q[4], q[5], q[6], q[7]) >= 0.0);
+
+        canvas_clear(a, 0.0f);
+        canvas_clear(b, 0.0f);
+        fill_triangle_f(a, NULL, q[0], q[1], 0, q[2], q[3], 0, q[4], q[5], 0, 1.0f);
+        fill_triangle_f(b, NULL, q[0], q[1], 0, q[6], q[7], 0, q[4], q[5], 0, 1.0f);
+
+        float tri_a[6] = { q[0], q[1], q[2], q[3], q[4], q[5] };
+        if (!check_coverage(a, tri_a)) {
+            printf("❌ coverage mismatch in trial %d\n", t);
+            ++failures;
+        }
+        for (int i = 0; i < WIDTH * HEIGHT; ++i) {
+            if (a->data[i] > 0.0f && b->data[i] > 0.0f) {
+                printf("❌ shared edge drawn twice in trial %d\n", t);
+                ++failures;
+                break;
+            }
+        }
+    }
+
+    // Depth test: the nearer triangle wins regardless of submission order
+    canvas_clear(a, 0.0f);
+    canvas_clear(b, 0.0f);
+    canvas_clear(depth, 1.0f);
+    fill_triangle_f(a, depth, 10, 10, 0.2f, 190, 20, 0.2f, 60, 150, 0.2f, 0.25f);
+    fill_triangle_f(a, depth, 20, 140, 0.5f, 180, 10, -0.5f, 190, 150, 0.5f, 0.75f);
+    canvas_clear(depth, 1.0f);
+    fill_triangle_f(b, depth, 20, 140, 0.5f, 180, 10, -0.5f, 190, 150, 0.5f, 0.75f);
+    fill_triangle_f(b, depth, 10, 10, 0.2f, 190, 20, 0.2f, 60, 150, 0.2f, 0.25f);
+    int both = 0;
+    for (int i = 0; i < WIDTH * HEIGHT; ++i) {
+        if (a->data[i] != b->data[i]) {
+            printf("❌ depth test depends on draw order\n");
+            ++failures;
+            break;
+        }
+        if (a->data[i] == 0.25f) both |= 1;
+        if (a->data[i] == 0.75f) both |= 2;
+    }
+    if (both != 3) {
+        printf("❌ depth test hid a triangle entirely\n");
+        ++failures;
+    }
+
+    // Overlay: a line behind the fill stays hidden, one on its surface
+    // replaces the brighter fill instead of losing the max-blend
+    canvas_clear(a, 0.0f);
+    canvas_clear(depth, 1.0f);
+    fill_triangle_f(a, depth, 0, 0, 0.2f, 400, 0, 0.2f, 0, 400, 0.2f, 1.0f);
+    draw_line_depth_f(a, depth, 20, 30, 0.5f, 180, 60, 0.5f, 0.3f, 1e-3f);
+    int hidden = 1, shown = 0;
+    for (int i = 0; i < WIDTH * HEIGHT; ++i) hidden &= a->data[i] == 1.0f;
+    draw_line_depth_f(a, depth, 20, 30, 0.2f, 180, 60, 0.2f, 0.3f, 1e-3f);
+    for (int i = 0; i < WIDTH * HEIGHT; ++i) shown += a->data[i] == 0.3f;
+    // Sub-pixel edges are dropped, as draw_line_f drops them
+    draw_line_depth_f(a, depth, 100.2f, 120.2f, 0.2f, 100.6f, 120.7f, 0.2f, 0.6f, 1e-3f);
+    hidden = hidden && a->data[120 * WIDTH + 100] == 1.0f;
+    if (!hidden || shown < 160) {
+        printf("❌ depth-tested overlay line\n");
+        ++failures;
+    }
+
+    // Faces longer than RENDER_FACE_MAX are skipped, not cut to a prefix
+    vec3_t ring[RENDER_FACE_MAX + 1];
+    int face[RENDER_FACE_MAX + 1];
+    mat4_t identity;
+    mat4_identity(&identity);
+    vec3_t light = vec3_init(0, 0, 1);
+    for (int n = RENDER_FACE_MAX; n <= RENDER_FACE_MAX + 1; ++n) {
+        for (int i = 0; i < n; ++i) {
+            ring[i] = vec3_init(0.5f * cosf(6.2831853f * i / n), 0.5f * sinf(6.2831853f * i / n), 0);
+            face[i] = i;
+        }
+        canvas_clear(a, 0.0f);
+        render_faces_lit(a, NULL, ring, face, n, 1, &identity, &identity, &identity, &light, 1, 0.2f);
+        int lit = 0;
+        for (int i = 0; i < WIDTH * HEIGHT; ++i) lit += a->data[i] > 0.0f;
+        if ((n <= RENDER_FACE_MAX) != (lit > 0)) {
+            printf("❌ %d-vertex face %s\n", n, lit ? "drawn" : "not drawn");
+            ++failures;
+        }
+    }
+
+    canvas_destroy(a);
+    canvas_destroy(b);
+    canvas_destroy(depth);
+    if (failures) return 1;
+    printf("✅ Coverage, shared edges, depth test and overlay correct\n");
+    return 0;
+}
@@ -0,0 +1,99 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include "canvas.h"
+#include "shmring.h"
+
+#define WIDTH  320
+#define HEIGHT 240
+#define FRAMES 400
+
+// Child process: every frame it manages to read must be uniformly filled
+// with its own frame number, i.e. never torn between two frames.
+static int consume(const char* name) {
+    shm_ring_t* ring = NULL;
+    for (int i = 0; i < 1000 && !ring; ++i) {
+        ring = shm_ring_open(name);
+        if (!ring) usleep(1000);
+    }
+    if (!ring) return 2;
+
+    canvas_t* c = canvas_create(WIDTH, HEIGHT);
+    uint64_t last = 0;
+    int bad = 0, seen = 0;
+    while (last < FRAMES) {
+        uint64_t frame = shm_ring_read_latest(ring, c);
+        if (frame == 0 || frame == last) continue;
+        if (frame < last) ++bad;
+        for (int i = 0; i < WIDTH * HEIGHT; ++i) {
+            if (c->data[i] != (float)frame) {
+                ++bad;
+                break;
+            }
+        }
+        last = frame;
+        ++seen;
+    }
+    canvas_destroy(c);
+    shm_ring_destroy(ring);
+    printf("consumer saw %d of %d frames\n", seen, FRAMES);
+    fflush(stdout);
+    return bad ? 1 : 0;
+}
+
+int main() {
+    char name[64];
+    snprintf(name, sizeof(name), "/tiny3d_test_%d", (int)getpid());
+
+    shm_ring_t* ring = shm_ring_create(name, 3, WIDTH, HEIGHT, 0);
+    if (!ring) {
+        printf("❌ could not create %s\n", name);
+        return 1;
+    }
+    // A second publisher must not take over a live ring
+    shm_ring_t* rival = shm_ring_create(name, 3, WIDTH, HEIGHT, 0);
+    if (rival) {
+        printf("❌ second create replaced a live ring\n");
+        shm_ring_destroy(rival);
+        shm_ring_destroy(ring);
+        return 1;
+    }
+
+    pid_t pid = fork();
+    if (pid == 0) _exit(consume(name));
+
+    printf("=== Shared-Memory Frame Ring ===\n");
+    for (int f = 1; f <= FRAMES; ++f) {
+        canvas_t* c = shm_ring_begin_frame(ring);
+        canvas_clear(c, (float)f);
+        shm_ring_publish(ring);
+        if (f % 50 == 0) usleep(2000);
+    }
+
+    int status = 0;
+    waitpid(pid, &status, 0);
+    shm_ring_destroy(ring);
+    if (!WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+        printf("❌ consumer observed torn or out-of-order frames\n");
+        return 1;
+    }
+
+    // A publisher that dies without cleaning up leaves a stale object behind;
+    // the next create must reclaim it
+    pid = fork();
+    if (pid == 0) _exit(shm_ring_create(name, 3, WIDTH, HEIGHT, 0) ? 0 : 1);
+    waitpid(pid, &status, 0);
+    ring = WIFEXITED(status) && WEXITSTATUS(status) == 0
+               ? shm_ring_create(name, 3, WIDTH, HEIGHT, 0) : NULL;
+    if (!ring) {
+        printf("❌ stale ring left by a crashed publisher was not reclaimed\n");
+        shm_unlink(name);
+        return 1;
+    }
+    shm_ring_destroy(ring);
+
+    printf("✅ All frames read consistently across processes\n");
+    return 0;
+}
@@ -0,0 +1,122 @@
+#include "canvas.h"
+#include "raster.h"
+#include "renderer.h"
+#include "lighting.h"
+#include "soccerball.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+// Fill-rate comparison: SIMD triangle fill vs the sampled line path, plus a
+// solid vs wireframe soccer ball frame. Writes build/solid.pgm as a visual check.
+
+#define WIDTH 1024
+#define HEIGHT 768
+#define PRIMS 20000
+#define SIZE 64.0f
+#define BALL_FRAMES 200
+
+static double now(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static float frand(float lo, float hi) {
+    return lo + (hi - lo) * (rand() / (float)RAND_MAX);
+}
+
+int main(void) {
+    canvas_t* c = canvas_create(WIDTH, HEIGHT);
+    canvas_t* depth = canvas_create(WIDTH, HEIGHT);
+    float* v = malloc(sizeof(float) * PRIMS * 6);
+    if (!c || !depth || !v) return 1;
+
+    // Same random anchors for both paths
+    srand(3);
+    for (int i = 0; i < PRIMS; ++i) {
+        float x = frand(0, WIDTH - SIZE), y = frand(0, HEIGHT - SIZE);
+        v[i * 6 + 0] = x + frand(0, SIZE); v[i * 6 + 1] = y + frand(0, SIZE);
+        v[i * 6 + 2] = x + frand(0, SIZE); v[i * 6 + 3] = y + frand(0, SIZE);
+        v[i * 6 + 4] = x + frand(0, SIZE); v[i * 6 + 5] = y + frand(0, SIZE);
+    }
+
+    // Triangles: pixels covered = sum of areas
+    double area = 0.0;
+    for (int i = 0; i < PRIMS; ++i) {
+        const float* t = &v[i * 6];
+        area += fabs((t[2] - t[0]) * (t[5] - t[1]) - (t[3] - t[1]) * (t[4] - t[0])) * 0.5;
+    }
+    canvas_clear(c, 0.0f);
+    double t0 = now();
+    for (int i = 0; i < PRIMS; ++i) {
+        const float* t = &v[i * 6];
+        fill_triangle_f(c, NULL, t[0], t[1], 0, t[2], t[3], 0, t[4], t[5], 0, 1.0f);
+    }
+    double fill_time = now() - t0;
+
+    // Lines: pixels covered = major-axis length of each of the three edges
+    double length = 0.0;
+    for (int i = 0; i < PRIMS; ++i) {
+        const float* t = &v[i * 6];
+        for (int e = 0; e < 3; ++e) {
+            int a = e * 2, b = ((e + 1) % 3) * 2;
+            length += fmax(fabs(t[b] - t[a]), fabs(t[b + 1] - t[a + 1]));
+        }
+    }
+    canvas_clear(c, 0.0f);
+    t0 = now();
+    for (int i = 0; i < PRIMS; ++i) {
+        const float* t = &v[i * 6];
+        for (int e = 0; e < 3; ++e) {
+            int a = e * 2, b = ((e + 1) % 3) * 2;
+            draw_line_f(c, t[a], t[a + 1], t[b], t[b + 1], 1.0f);
+        }
+    }
+    double line_time = now() - t0;
+
+    printf("triangle fill: %8.1f Mpix/s (%d tris, %.0f px)\n", area / fill_time * 1e-6, PRIMS, area);
+    printf("line path:     %8.1f Mpix/s (%d lines, %.0f px)\n", length / line_time * 1e-6, PRIMS * 3, length);
+
+    // Whole frames: lit wireframe vs solid faces + wireframe overlay
+    vec3_t vertices[SOCCERBALL_VERTEX_COUNT];
+    int edges[SOCCERBALL_EDGE_MAX][2], edge_count;
+    int faces[SOCCERBALL_FACE_COUNT][SOCCERBALL_FACE_MAX];
+    generate_soccerball(vertices, edges, &edge_count);
+    generate_soccerball_faces(faces);
+
+    vec3_t lights[1] = { vec3_normalize(vec3_init(1.0f, 1.0f, 1.0f)) };
+    mat4_t proj, view, model;
+    mat4_perspective(&proj, M_PI / 3.0f, (float)WIDTH / HEIGHT, 0.1f, 100.0f);
+    mat4_lookat(&view, vec3_init(0, 0, 3), vec3_init(0, 0, 0), vec3_init(0, 1, 0));
+    quat_to_mat4(&model, quat_from_axis_angle(vec3_normalize(vec3_init(1, 1, 0)), 0.8f));
+
+    t0 = now();
+    for (int f = 0; f < BALL_FRAMES; ++f) {
+        canvas_clear(c, 0.0f);
+        render_wireframe_lit(c, vertices, (const int (*)[2])edges, SOCCERBALL_VERTEX_COUNT, edge_count,
+                             &model, &view, &proj, lights, 1, 0.2f);
+    }
+    double wire_time = now() - t0;
+
+    t0 = now();
+    for (int f = 0; f < BALL_FRAMES; ++f) {
+        canvas_clear(c, 0.0f);
+        canvas_clear(depth, 1.0f);
+        render_faces_lit(c, depth, vertices, &faces[0][0], SOCCERBALL_FACE_MAX, SOCCERBALL_FACE_COUNT,
+                         &model, &view, &proj, lights, 1, 0.2f);
+        render_wireframe_overlay(c, depth, vertices, (const int (*)[2])edges, edge_count,
+                                 &model, &view, &proj, lights, 1, 0.2f, 1e-3f);
+    }
+    double solid_time = now() - t0;
+
+    printf("wireframe ball: %6.3f ms/frame\n", wire_time / BALL_FRAMES * 1e3);
+    printf("solid ball:     %6.3f ms/frame (faces + overlay)\n", solid_time / BALL_FRAMES * 1e3);
+    canvas_to_pgm(c, "build/solid.pgm");
+
+    free(v);
+    canvas_destroy(c);
+    canvas_destroy(depth);
+    return 0;
+}
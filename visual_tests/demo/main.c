@@ -4,12 +4,21 @@
 #include "renderer.h"
 #include "lighting.h"
 #include "soccerball.h"
+#include "delta.h"
+#include "fixed.h"
+#include "shmring.h"
 #include <math.h>
 #include <stdio.h>
+#include <string.h>
+#include <time.h>
 
 #define WIDTH 512
 #define HEIGHT 512
 #define FRAME_COUNT 120
+#define SHM_RING_NAME "/tiny3d_demo"
+#define SHM_RING_SLOTS 3
+#define POSTER_SIZE 16384
+#define POSTER_BAND 64
 
 // Cube vertices and edges
 static const vec3_t cube_vertices[] = {
@@ -43,8 +52,119 @@ static const int pyramid_edges[][2] = {
 #define PYRAMID_VERTEX_COUNT (sizeof(pyramid_vertices) / sizeof(vec3_t))
 #define PYRAMID_EDGE_COUNT   (sizeof(pyramid_edges)   / sizeof(pyramid_edges[0]))
 
-int main(void) {
-    canvas_t* canvas = canvas_create(WIDTH, HEIGHT);
+#ifdef TINY3D_FIXED_POINT
+// Integer build (make FIXED=1): scene data is converted to Q16.16 at the
+// API boundary and rendered into an 8-bit canvas
+typedef canvas8_t demo_canvas_t;
+
+static void draw_object(demo_canvas_t* c, const bvh_t* bvh,
+                        const vec3_t* vertices, const int edges[][2], int vcount, int ecount,
+                        const mat4_t* model, const mat4_t* view, const mat4_t* proj,
+                        const vec3_t* lights, int light_count, float ambient) {
+    (void)bvh;
+    vec3_fx_t v[SOCCERBALL_VERTEX_COUNT], l[4];
+    mat4_fx_t m, vw, p;
+    for (int i = 0; i < vcount; ++i) v[i] = vec3_to_fx(vertices[i]);
+    for (int i = 0; i < light_count; ++i) l[i] = vec3_to_fx(lights[i]);
+    mat4_to_fx(&m, model);
+    mat4_to_fx(&vw, view);
+    mat4_to_fx(&p, proj);
+    render_wireframe_lit_fx(c, v, edges, vcount, ecount, &m, &vw, &p, l, light_count,
+                            fx_from_float(ambient));
+}
+
+static demo_canvas_t* demo_canvas_create(void) { return canvas8_create(WIDTH, HEIGHT); }
+static void demo_canvas_clear(demo_canvas_t* c) { canvas8_clear(c, 0); }
+static void demo_canvas_destroy(demo_canvas_t* c) { canvas8_destroy(c); }
+static void demo_canvas_save(demo_canvas_t* c, const char* filename) { canvas8_to_pgm(c, filename); }
+static int demo_delta_add(delta_writer_t* w, demo_canvas_t* c) { return delta_writer_add8(w, c); }
+static void demo_line(demo_canvas_t* c, int x0, int y0, int x1, int y1) {
+    draw_line_fx(c, x0 << FX_SHIFT, y0 << FX_SHIFT, x1 << FX_SHIFT, y1 << FX_SHIFT, 255);
+}
+#else
+typedef canvas_t demo_canvas_t;
+
+// Worker pool for rendering and PGM encoding, owned by main
+static job_system_t* jobs = NULL;
+
+// --poster: frame 0 is collected here and streamed out band by band
+static band_renderer_t* poster = NULL;
+
+static void draw_object(demo_canvas_t* c, const bvh_t* bvh,
+                        const vec3_t* vertices, const int edges[][2], int vcount, int ecount,
+                        const mat4_t* model, const mat4_t* view, const mat4_t* proj,
+                        const vec3_t* lights, int light_count, float ambient) {
+    if (poster)
+        band_renderer_add_lit(poster, vertices, edges, ecount, model, view, proj,
+                              lights, light_count, ambient);
+    // Objects with a BVH (the soccer ball) are deliberately drawn serially:
+    // the tree culls off-screen clusters, and one ~90-edge mesh is far too
+    // little work to split across the pool
+    else if (bvh)
+        render_wireframe_lit_bvh(c, bvh, vertices, edges, ecount, model, view, proj,
+                                 lights, light_count, ambient, 0.0f);
+    else
+        render_wireframe_lit_mt(jobs, c, vertices, edges, vcount, ecount, model, view, proj,
+                                lights, light_count, ambient);
+}
+
+static demo_canvas_t* demo_canvas_create(void) { return canvas_create(WIDTH, HEIGHT); }
+static void demo_canvas_clear(demo_canvas_t* c) { canvas_clear(c, 0.0f); }
+static void demo_canvas_destroy(demo_canvas_t* c) { canvas_destroy(c); }
+static void demo_canvas_save(demo_canvas_t* c, const char* filename) { canvas_to_pgm_mt(jobs, c, filename); }
+static int demo_delta_add(delta_writer_t* w, demo_canvas_t* c) { return delta_writer_add(w, c); }
+static void demo_line(demo_canvas_t* c, int x0, int y0, int x1, int y1) {
+    if (poster) {
+        float s = (float)POSTER_SIZE / WIDTH;
+        band_renderer_add_line(poster, x0 * s, y0 * s, x1 * s, y1 * s, 1.0f);
+        return;
+    }
+    draw_line_f(c, x0, y0, x1, y1, 1.0f);
+}
+#endif
+
+int main(int argc, char** argv) {
+    demo_canvas_t* offscreen = demo_canvas_create();
+
+    // --delta: write one keyframe + delta sequence instead of 120 PGMs
+    delta_writer_t* seq = NULL;
+    if (argc > 1 && strcmp(argv[1], "--delta") == 0) {
+        seq = delta_writer_open("build/frames.t3ds", WIDTH, HEIGHT, 30);
+        if (!seq) {
+            fprintf(stderr, "cannot open build/frames.t3ds\n");
+            return 1;
+        }
+    }
+
+    // --shm: render straight into a shared-memory ring for build/shm_consumer
+    shm_ring_t* ring = NULL;
+    if (argc > 1 && strcmp(argv[1], "--shm") == 0) {
+#ifdef TINY3D_FIXED_POINT
+        fprintf(stderr, "--shm needs the float build\n");
+        return 1;
+#else
+        ring = shm_ring_create(SHM_RING_NAME, SHM_RING_SLOTS, WIDTH, HEIGHT, 0);
+        if (!ring) {
+            fprintf(stderr, "cannot create shared memory %s\n", SHM_RING_NAME);
+            return 1;
+        }
+        printf("📡 Publishing to %s\n", SHM_RING_NAME);
+#endif
+    }
+
+    // --poster: first frame at POSTER_SIZE^2, streamed in POSTER_BAND-row strips
+    if (argc > 1 && strcmp(argv[1], "--poster") == 0) {
+#ifdef TINY3D_FIXED_POINT
+        fprintf(stderr, "--poster needs the float build\n");
+        return 1;
+#else
+        poster = band_renderer_create(POSTER_SIZE, POSTER_SIZE, POSTER_BAND);
+        if (!poster) {
+            fprintf(stderr, "cannot allocate a %d-row band\n", POSTER_BAND);
+            return 1;
+        }
+#endif
+    }
 
     mat4_t proj, view;
     mat4_perspective(&proj, M_PI / 3.0f, (float)WIDTH / HEIGHT, 0.1f, 100.0f);
@@ -54,12 +174,23 @@ int main(void) {
     int soccer_edges[SOCCERBALL_EDGE_MAX][2];
     int soccer_edge_count = 0;
     generate_soccerball(soccer_vertices, soccer_edges, &soccer_edge_count);
+    bvh_t* soccer_bvh = bvh_build(soccer_vertices, (const int (*)[2])soccer_edges, soccer_edge_count);
+
+#ifndef TINY3D_FIXED_POINT
+    // One thread per core; if creation fails, NULL makes every call serial
+    jobs = jobs_create(0);
+#endif
 
     for (int frame = 0; frame < FRAME_COUNT; ++frame) {
         float t = (float)frame / (FRAME_COUNT - 1);  // ✅ ensures start == end pose
         float theta = 2.0f * M_PI * t;
 
-        canvas_clear(canvas, 0.0f);
+        demo_canvas_t* canvas = offscreen;
+#ifndef TINY3D_FIXED_POINT
+        if (ring) canvas = shm_ring_begin_frame(ring);
+#endif
+
+        demo_canvas_clear(canvas);
 
         // 🔆 Light orbiting overhead
         vec3_t light = vec3_normalize(vec3_init(cosf(theta), 1.0f, sinf(theta)));
@@ -82,8 +213,8 @@ int main(void) {
         quat_to_mat4(&cube_rot, q_total);
         mat4_translate(&cube_trans, cube_pos);
         mat4_multiply(&cube_model, &cube_rot, &cube_trans);
-        render_wireframe_lit(canvas, cube_vertices, cube_edges, CUBE_VERTEX_COUNT, CUBE_EDGE_COUNT,
-                             &cube_model, &view, &proj, lights, 1, 0.2f);
+        draw_object(canvas, NULL, cube_vertices, cube_edges, CUBE_VERTEX_COUNT, CUBE_EDGE_COUNT,
+                    &cube_model, &view, &proj, lights, 1, 0.2f);
 
         // 🔺 Pyramid (counter-orbit + spin)
         // ➡️ Pyramid Bezier path (right loop)
@@ -98,8 +229,8 @@ int main(void) {
         quat_to_mat4(&pyr_rot, q_pyr);
         mat4_translate(&pyr_trans, pyr_pos);
         mat4_multiply(&pyr_model, &pyr_rot, &pyr_trans);
-        render_wireframe_lit(canvas, pyramid_vertices, pyramid_edges, PYRAMID_VERTEX_COUNT, PYRAMID_EDGE_COUNT,
-                             &pyr_model, &view, &proj, lights, 1, 0.2f);
+        draw_object(canvas, NULL, pyramid_vertices, pyramid_edges, PYRAMID_VERTEX_COUNT, PYRAMID_EDGE_COUNT,
+                    &pyr_model, &view, &proj, lights, 1, 0.2f);
 
         // ⚽ Soccerball — Bezier orbit + smooth spin
         vec3_t p0 = vec3_init(-1.2f, 0.0f, -5.0f);
@@ -115,22 +246,58 @@ int main(void) {
         mat4_translate(&ball_trans, ball_pos);
         mat4_multiply(&ball_model, &ball_rot, &ball_trans);
 
-        // ⚽ soccer_vertices and soccer_edges already filled before the loop
-        render_wireframe_lit(canvas, soccer_vertices, soccer_edges,
-                            SOCCERBALL_VERTEX_COUNT, soccer_edge_count,
-                            &ball_model, &view, &proj, lights, 1, 0.2f);
+        // ⚽ soccer_vertices, soccer_edges and soccer_bvh already built before the loop
+        draw_object(canvas, soccer_bvh, soccer_vertices, (const int (*)[2])soccer_edges,
+                    SOCCERBALL_VERTEX_COUNT, soccer_edge_count,
+                    &ball_model, &view, &proj, lights, 1, 0.2f);
 
         // ☀️ Center sun crosshair
-        draw_line_f(canvas, WIDTH/2 - 3, HEIGHT/2, WIDTH/2 + 3, HEIGHT/2, 1.0f);
-        draw_line_f(canvas, WIDTH/2, HEIGHT/2 - 3, WIDTH/2, HEIGHT/2 + 3, 1.0f);
+        demo_line(canvas, WIDTH/2 - 3, HEIGHT/2, WIDTH/2 + 3, HEIGHT/2);
+        demo_line(canvas, WIDTH/2, HEIGHT/2 - 3, WIDTH/2, HEIGHT/2 + 3);
+
+#ifndef TINY3D_FIXED_POINT
+        // 🖼️ Poster: one frame, written strip by strip
+        if (poster) {
+            if (band_renderer_write_pgm(poster, "build/poster.pgm") != 0) {
+                fprintf(stderr, "cannot write build/poster.pgm\n");
+                break;
+            }
+            printf("✅ Saved build/poster.pgm (%dx%d)\n", POSTER_SIZE, POSTER_SIZE);
+            break;
+        }
+#endif
+
+        // 📡 Hand the slot to viewers, paced at ~30 fps
+        if (ring) {
+            shm_ring_publish(ring);
+            nanosleep(&(struct timespec){ 0, 33000000L }, NULL);
+            continue;
+        }
 
         // 💾 Save frame into build/
+        if (seq) {
+            if (demo_delta_add(seq, canvas) != 0) {
+                fprintf(stderr, "cannot write frame %d to build/frames.t3ds\n", frame);
+                break;
+            }
+            continue;
+        }
         char filename[64];
         snprintf(filename, sizeof(filename), "build/frame_%03d.pgm", frame);
-        canvas_to_pgm(canvas, filename);
+        demo_canvas_save(canvas, filename);
         printf("✅ Saved %s\n", filename);
     }
 
-    canvas_destroy(canvas);
+    if (seq) {
+        printf("✅ Saved build/frames.t3ds (%d frames)\n", seq->frame_count);
+        delta_writer_close(seq);
+    }
+    shm_ring_destroy(ring);
+#ifndef TINY3D_FIXED_POINT
+    band_renderer_destroy(poster);
+    jobs_destroy(jobs);
+#endif
+    bvh_destroy(soccer_bvh);
+    demo_canvas_destroy(offscreen);
     return 0;
 }
@@ -0,0 +1,76 @@
+#include "canvas.h"
+#include "shmring.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+// Reference viewer for the demo's --shm mode: follows the newest frame in
+// the ring, inspects it in place and optionally dumps the last one as PGM.
+// Usage: shm_consumer [name] [frames] [last_frame.pgm]
+
+#define IDLE_TIMEOUT_MS 2000
+
+static void sleep_ms(int ms) {
+    struct timespec ts = { ms / 1000, (ms % 1000) * 1000000L };
+    nanosleep(&ts, NULL);
+}
+
+int main(int argc, char** argv) {
+    const char* name = argc > 1 ? argv[1] : "/tiny3d_demo";
+    int wanted = argc > 2 ? atoi(argv[2]) : 0;
+    const char* dump = argc > 3 ? argv[3] : NULL;
+
+    shm_ring_t* ring = NULL;
+    for (int waited = 0; !ring && waited < IDLE_TIMEOUT_MS; waited += 10) {
+        ring = shm_ring_open(name);
+        if (!ring) sleep_ms(10);
+    }
+    if (!ring) {
+        fprintf(stderr, "no ring named %s\n", name);
+        return 1;
+    }
+    printf("📺 %s: %d slots of %dx%d\n", name, ring->slot_count, ring->width, ring->height);
+
+    uint64_t last = 0;
+    int received = 0, torn = 0, idle = 0;
+    while ((wanted == 0 || received < wanted) && idle < IDLE_TIMEOUT_MS) {
+        if (shm_ring_latest(ring) == last) {
+            sleep_ms(1);
+            ++idle;
+            continue;
+        }
+
+        uint64_t frame;
+        uint32_t token;
+        const float* pixels = shm_ring_read_begin(ring, &frame, &token);
+        if (!pixels) continue;
+
+        // Work directly on the shared pixels — no copy
+        size_t n = (size_t)ring->width * ring->height, lit = 0;
+        double sum = 0.0;
+        for (size_t i = 0; i < n; ++i) {
+            if (pixels[i] > 0.0f) ++lit;
+            sum += pixels[i];
+        }
+        if (!shm_ring_read_end(ring, frame, token)) {
+            ++torn;          // overwritten while we looked; try the newer one
+            continue;
+        }
+
+        printf("frame %llu: %zu lit pixels, mean %.5f (skipped %llu)\n",
+               (unsigned long long)frame, lit, sum / n,
+               (unsigned long long)(last ? frame - last - 1 : frame - 1));
+        last = frame;
+        ++received;
+        idle = 0;
+    }
+
+    if (dump && last) {
+        canvas_t* c = canvas_create(ring->width, ring->height);
+        if (shm_ring_read_latest(ring, c)) canvas_to_pgm(c, dump);
+        canvas_destroy(c);
+    }
+    printf("✅ %d frames received, %d torn reads retried\n", received, torn);
+    shm_ring_destroy(ring);
+    return 0;
+}